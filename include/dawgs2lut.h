@@ -0,0 +1,145 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "genericrgb.h"
+
+namespace daw {
+	namespace imaging {
+		// Per channel sums of an image, the global input of FilterDAWGS2.  They are
+		// integers so partial sums can be merged in any order
+		struct DAWGS2Sums {
+			uintmax_t red = 0;
+			uintmax_t green = 0;
+			uintmax_t blue = 0;
+
+			// Add count pixels, a row or less.  Row sums fit in 32bits for widths
+			// up to 16 million
+			void add( rgb3 const *pixels, size_t const count ) noexcept {
+				uint32_t r = 0;
+				uint32_t g = 0;
+				uint32_t b = 0;
+				for( size_t n = 0; n < count; ++n ) {
+					r += pixels[n].red;
+					g += pixels[n].green;
+					b += pixels[n].blue;
+				}
+				red += r;
+				green += g;
+				blue += b;
+			}
+
+			DAWGS2Sums &operator+=( DAWGS2Sums const &rhs ) noexcept {
+				red += rhs.red;
+				green += rhs.green;
+				blue += rhs.blue;
+				return *this;
+			}
+		};
+
+		// Maps a pixel to its FilterDAWGS2 level with three table lookups.  Each
+		// channel's contribution to the output level is stored in fixed point
+		// with fraction_bits fractional bits.  Entries saturate just above 255 so
+		// that the sum of three never overflows.  bias covers the rounding of the
+		// three entries so that exact integer levels do not floor to the level
+		// below
+		class DAWGS2LUT {
+		public:
+			using table_t = std::array<uint32_t, 256>;
+			static constexpr uint32_t fraction_bits = 20;
+			static constexpr uint32_t saturate = 256U << fraction_bits;
+			static constexpr uint32_t bias = 2;
+
+		private:
+			table_t m_red;
+			table_t m_green;
+			table_t m_blue;
+
+			DAWGS2LUT( ) = default;
+
+		public:
+			// The output level is ( r/wr + g/wg + b/wb )/( 3*dv ) where each weight
+			// is the channel mean relative to the brightest channel mean and dv is
+			// the mean weight.  A channel with a zero weight saturates whenever
+			// it is non zero, a black image keeps equal weights
+			static DAWGS2LUT from_sums( DAWGS2Sums sums, size_t const size ) {
+				if( size > 0 ) {
+					sums.red /= size;
+					sums.green /= size;
+					sums.blue /= size;
+				}
+
+				auto const mx = std::max( {sums.red, sums.green, sums.blue} );
+				auto const weight = [mx]( uintmax_t const mean ) {
+					if( mx == 0 ) {
+						return 1.0;
+					}
+					return static_cast<double>( mean ) / static_cast<double>( mx );
+				};
+				auto const w_red = weight( sums.red );
+				auto const w_green = weight( sums.green );
+				auto const w_blue = weight( sums.blue );
+				auto const dv = ( w_red + w_green + w_blue ) / 3.0;
+
+				auto const fill = [dv]( table_t &lut, double const w ) {
+					lut[0] = 0;
+					for( size_t n = 1; n < lut.size( ); ++n ) {
+						if( w <= 0.0 ) {
+							lut[n] = saturate;
+							continue;
+						}
+						auto const value =
+						  std::round( ( static_cast<double>( n ) / w ) / dv / 3.0 *
+						              static_cast<double>( 1U << fraction_bits ) );
+						lut[n] = value >= static_cast<double>( saturate )
+						           ? saturate
+						           : static_cast<uint32_t>( value );
+					}
+				};
+				DAWGS2LUT result{};
+				fill( result.m_red, w_red );
+				fill( result.m_green, w_green );
+				fill( result.m_blue, w_blue );
+				return result;
+			}
+
+			uint8_t operator( )( uint8_t const red, uint8_t const green,
+			                     uint8_t const blue ) const noexcept {
+				auto const level =
+				  ( m_red[red] + m_green[green] + m_blue[blue] + bias ) >>
+				  fraction_bits;
+				return static_cast<uint8_t>( std::min( level, 255U ) );
+			}
+
+			uint8_t operator( )( rgb3 const &pixel ) const noexcept {
+				return operator( )( pixel.red, pixel.green, pixel.blue );
+			}
+		};
+	} // namespace imaging
+} // namespace daw
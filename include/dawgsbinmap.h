@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace daw {
+	namespace imaging {
+		// Maps too_gs keys to one of 256 output levels.  A level is the first bin
+		// whose boundary is >= the key.  The boundaries are sorted and the last
+		// one is the largest key in the image, so the lookup is a fixed 8 step
+		// branchless binary search.  Pixels are mapped in blocks with the search
+		// step as the outer loop so that the inner loop over pixels vectorizes
+		class DAWGSBinMap {
+		public:
+			using key_t = uint32_t;
+			using bins_t = std::array<key_t, 256>;
+			static constexpr size_t block_size = 64;
+
+		private:
+			bins_t m_bins;
+
+		public:
+			constexpr DAWGSBinMap( bins_t const &bins ) noexcept
+			  : m_bins( bins ) {}
+
+			// Keys is a sorted, distinct, random access range of more than 256
+			// keys.  The boundaries are evenly spaced by rank
+			template<typename Keys>
+			static DAWGSBinMap from_keys( Keys const &keys ) {
+				bins_t bins{};
+				auto const inc = static_cast<float>( keys.size( ) ) / 256.0f;
+				for( size_t n = 0; n < 255; ++n ) {
+					bins[n] = keys[static_cast<size_t>( static_cast<float>( n ) * inc )];
+				}
+				bins[255] = keys.back( );
+				return DAWGSBinMap{bins};
+			}
+
+			constexpr bins_t const &bins( ) const noexcept {
+				return m_bins;
+			}
+
+			constexpr uint8_t operator( )( key_t const key ) const noexcept {
+				size_t pos = 0;
+				for( size_t step = 128; step > 0; step /= 2 ) {
+					pos += static_cast<size_t>( m_bins[pos + step - 1] < key ) * step;
+				}
+				return static_cast<uint8_t>( pos );
+			}
+
+			// out[n] = level of key_of( first[n] ) for every pixel in [first, last)
+			template<typename Pixel, typename Out, typename KeyFunc>
+			void map( Pixel const *first, Pixel const *const last, Out *out,
+			          KeyFunc key_of ) const noexcept {
+				std::array<key_t, block_size> keys;
+				std::array<key_t, block_size> pos;
+				while( first != last ) {
+					auto const count = static_cast<size_t>( last - first ) < block_size
+					                     ? static_cast<size_t>( last - first )
+					                     : block_size;
+					for( size_t n = 0; n < count; ++n ) {
+						keys[n] = key_of( first[n] );
+						pos[n] = 0;
+					}
+					for( key_t step = 128; step > 0; step /= 2 ) {
+						for( size_t n = 0; n < count; ++n ) {
+							pos[n] += static_cast<key_t>( m_bins[pos[n] + step - 1] < keys[n] ) *
+							          step;
+						}
+					}
+					for( size_t n = 0; n < count; ++n ) {
+						out[n] = static_cast<uint8_t>( pos[n] );
+					}
+					first += count;
+					out += count;
+				}
+			}
+		};
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "imagebuffer.h"
+
+namespace daw {
+	namespace imaging {
+		// A set of FilterDAWGS::too_gs keys stored as a presence bitset.  Keys are
+		// bounded by 255 * 65535 so the whole set is ~2MB regardless of image size.
+		// Once all keys are inserted, build_ranks( ) computes popcount prefix sums
+		// so that the n'th smallest key can be found without materializing a
+		// sorted vector of keys
+		class DAWGSKeySet {
+		public:
+			using key_t = uint32_t;
+			using word_t = uint64_t;
+			static constexpr key_t max_key = 255u * ( 19595u + 38469u + 7471u );
+
+		private:
+			static constexpr size_t bits_per_word = 64;
+			static constexpr size_t word_count = max_key / bits_per_word + 1;
+
+			image_vector<word_t> m_words;
+			image_vector<uint32_t> m_ranks;
+			size_t m_size;
+
+		public:
+			DAWGSKeySet( );
+
+			DAWGSKeySet( DAWGSKeySet const & ) = default;
+			DAWGSKeySet( DAWGSKeySet && ) noexcept = default;
+			DAWGSKeySet &operator=( DAWGSKeySet const & ) = default;
+			DAWGSKeySet &operator=( DAWGSKeySet && ) noexcept = default;
+
+			~DAWGSKeySet( ) = default;
+
+			inline void insert( key_t const key ) noexcept {
+				m_words[key / bits_per_word] |= static_cast<word_t>( 1 )
+				                                << ( key % bits_per_word );
+			}
+
+			inline bool contains( key_t const key ) const noexcept {
+				return ( ( m_words[key / bits_per_word] >> ( key % bits_per_word ) ) &
+				         1 ) != 0;
+			}
+
+			// OR all of the partial sets together and rank the result.  The words
+			// are split across threads
+			static DAWGSKeySet merge( std::vector<DAWGSKeySet> partials );
+
+			// Must be called after the last insert and before size/operator[]/back
+			void build_ranks( );
+
+			inline size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			inline bool empty( ) const noexcept {
+				return 0 == m_size;
+			}
+
+			// The pos'th smallest key in the set
+			key_t operator[]( size_t const pos ) const;
+
+			key_t back( ) const;
+		};
+	} // namespace imaging
+} // namespace daw
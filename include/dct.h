@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "genericimage.h"
+
+namespace daw {
+	namespace imaging {
+		// Separable 8x8 DCT-II/DCT-III using the Arai, Agui and Nakajima
+		// factorisation: 5 multiplies per 1D forward transform plus one scale per
+		// coefficient.  Coefficients are orthonormal, F( 0, 0 ) is 8 times the
+		// block mean and blocks are row major with the frequency index v * 8 + u.
+		//
+		// The float transform is accurate to a small fraction of a level, the
+		// integer transform uses 13 bit fixed point constants and is within a
+		// level of the exact result
+		namespace dct {
+			constexpr size_t block_width = 8;
+			constexpr size_t block_size = block_width * block_width;
+
+			using float_block = std::array<float, block_size>;
+			using int_block = std::array<int32_t, block_size>;
+
+			void forward( float_block &block ) noexcept;
+			void inverse( float_block &block ) noexcept;
+
+			void forward( int_block &block ) noexcept;
+			void inverse( int_block &block ) noexcept;
+
+			// Number of blocks needed to cover a width x height image
+			constexpr size_t block_count( size_t const width,
+			                              size_t const height ) noexcept {
+				return ( ( width + block_width - 1 ) / block_width ) *
+				       ( ( height + block_width - 1 ) / block_width );
+			}
+
+			// Transform every 8x8 block of an image in parallel.  Blocks are in
+			// raster order and partial blocks at the right and bottom edges repeat
+			// the last column or row.  Block is float_block or int_block
+			template<typename Block>
+			std::vector<Block> forward_blocks( GenericImage<uint8_t> const &image );
+
+			// Rebuild a width x height image from its blocks in parallel, clamping
+			// each sample to 0 - 255
+			template<typename Block>
+			GenericImage<uint8_t> inverse_blocks( std::vector<Block> const &blocks,
+			                                      size_t const width,
+			                                      size_t const height );
+		} // namespace dct
+	}   // namespace imaging
+} // namespace daw
@@ -0,0 +1,193 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+namespace daw {
+	namespace imaging {
+		// A first in first out queue holding at most capacity items.  push blocks
+		// while the queue is full and pop blocks while it is empty, so a fast
+		// stage cannot run ahead of a slow one by more than capacity items.
+		// After close, push fails and pop drains the remaining items and then
+		// returns empty
+		template<typename T>
+		class BoundedQueue {
+			std::mutex m_mutex;
+			std::condition_variable m_not_full;
+			std::condition_variable m_not_empty;
+			std::deque<T> m_items;
+			size_t m_capacity;
+			bool m_closed;
+
+		public:
+			explicit BoundedQueue( size_t const capacity )
+			  : m_mutex{}
+			  , m_not_full{}
+			  , m_not_empty{}
+			  , m_items{}
+			  , m_capacity{capacity}
+			  , m_closed{false} {
+				daw::exception::daw_throw_on_false(
+				  capacity > 0, "BoundedQueue capacity must be non-zero" );
+			}
+
+			BoundedQueue( BoundedQueue const & ) = delete;
+			BoundedQueue &operator=( BoundedQueue const & ) = delete;
+
+			~BoundedQueue( ) = default;
+
+			// Returns false, dropping item, if the queue was closed
+			bool push( T item ) {
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_not_full.wait( lock, [this]( ) {
+					return m_closed || m_items.size( ) < m_capacity;
+				} );
+				if( m_closed ) {
+					return false;
+				}
+				m_items.push_back( std::move( item ) );
+				lock.unlock( );
+				m_not_empty.notify_one( );
+				return true;
+			}
+
+			std::optional<T> pop( ) {
+				std::unique_lock<std::mutex> lock( m_mutex );
+				m_not_empty.wait( lock,
+				                  [this]( ) { return m_closed || !m_items.empty( ); } );
+				if( m_items.empty( ) ) {
+					return std::nullopt;
+				}
+				auto result = std::optional<T>( std::move( m_items.front( ) ) );
+				m_items.pop_front( );
+				lock.unlock( );
+				m_not_full.notify_one( );
+				return result;
+			}
+
+			void close( ) {
+				{
+					std::lock_guard<std::mutex> lock( m_mutex );
+					m_closed = true;
+				}
+				m_not_full.notify_all( );
+				m_not_empty.notify_all( );
+			}
+		};
+
+		// Runs long lived stage functions, one thread each.  Stages block on
+		// their queues, so they get threads of their own rather than tasks on the
+		// shared scheduler that the parallel filters run on
+		class Executor {
+			std::vector<std::thread> m_threads;
+			std::mutex m_mutex;
+			std::exception_ptr m_error;
+
+		public:
+			Executor( )
+			  : m_threads{}
+			  , m_mutex{}
+			  , m_error{} {}
+
+			Executor( Executor const & ) = delete;
+			Executor &operator=( Executor const & ) = delete;
+
+			~Executor( ) {
+				for( auto &thread : m_threads ) {
+					if( thread.joinable( ) ) {
+						thread.join( );
+					}
+				}
+			}
+
+			// The first exception thrown by any stage is rethrown by wait
+			template<typename Func>
+			void spawn( Func func ) {
+				m_threads.emplace_back( [this, func = std::move( func )]( ) mutable {
+					try {
+						func( );
+					} catch( ... ) {
+						std::lock_guard<std::mutex> lock( m_mutex );
+						if( !m_error ) {
+							m_error = std::current_exception( );
+						}
+					}
+				} );
+			}
+
+			void wait( ) {
+				for( auto &thread : m_threads ) {
+					if( thread.joinable( ) ) {
+						thread.join( );
+					}
+				}
+				m_threads.clear( );
+				if( m_error ) {
+					std::rethrow_exception( std::exchange( m_error, nullptr ) );
+				}
+			}
+		};
+
+		// A fixed set of worker threads running queued tasks in order.  It is for
+		// request level work such as whole filters; each filter already spreads
+		// its own work across the cores, so a few workers are enough
+		class TaskPool {
+			std::mutex m_mutex;
+			std::condition_variable m_has_task;
+			std::deque<std::function<void( )>> m_tasks;
+			std::vector<std::thread> m_threads;
+			bool m_closed;
+
+			void run_tasks( );
+
+		public:
+			static constexpr size_t default_thread_count = 2;
+
+			explicit TaskPool( size_t const thread_count = default_thread_count );
+
+			TaskPool( TaskPool const & ) = delete;
+			TaskPool &operator=( TaskPool const & ) = delete;
+
+			// Runs the tasks already queued, then joins the workers
+			~TaskPool( );
+
+			// Tasks must not throw, errors are reported through their results
+			void add_task( std::function<void( )> task );
+		};
+
+		// The pool used by the filters' async variants
+		TaskPool &default_task_pool( );
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,101 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "orientedview.h"
+
+namespace daw {
+	namespace imaging {
+		namespace exif {
+			// The EXIF Orientation tag (0x0112) values 1 to 8 as the transform a
+			// viewer applies to the stored pixels
+			constexpr orientation from_tag_value( uint16_t const value ) noexcept {
+				switch( value ) {
+				case 2:
+					return orientation::flip_horizontal;
+				case 3:
+					return orientation::rotate_180;
+				case 4:
+					return orientation::flip_vertical;
+				case 5:
+					return orientation::transpose;
+				case 6:
+					return orientation::rotate_90;
+				case 7:
+					return orientation::transverse;
+				case 8:
+					return orientation::rotate_270;
+				default:
+					return orientation::identity;
+				}
+			}
+
+			constexpr uint16_t to_tag_value( orientation const o ) noexcept {
+				switch( o ) {
+				case orientation::flip_horizontal:
+					return 2;
+				case orientation::rotate_180:
+					return 3;
+				case orientation::flip_vertical:
+					return 4;
+				case orientation::transpose:
+					return 5;
+				case orientation::rotate_90:
+					return 6;
+				case orientation::transverse:
+					return 7;
+				case orientation::rotate_270:
+					return 8;
+				case orientation::identity:
+				default:
+					return 1;
+				}
+			}
+
+			// Where the Orientation value of a JPEG file's IFD0 is stored
+			struct orientation_tag {
+				size_t offset;
+				bool big_endian;
+			};
+
+			// Find the Orientation tag in the Exif APP1 segment of the JPEG file
+			// bytes.  Empty when the file has no Exif segment or no Orientation
+			// tag
+			std::optional<orientation_tag>
+			find_orientation_tag( std::vector<uint8_t> const &jpeg );
+
+			orientation read_orientation( std::vector<uint8_t> const &jpeg,
+			                              orientation_tag const &tag );
+
+			// Overwrite the tag in place, the rest of the file is untouched
+			void write_orientation( std::vector<uint8_t> &jpeg,
+			                        orientation_tag const &tag,
+			                        orientation const o );
+		} // namespace exif
+	}   // namespace imaging
+} // namespace daw
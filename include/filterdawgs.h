@@ -22,27 +22,105 @@
 
 #pragma once
 
+#include "future.h"
 #include "genericimage.h"
 #include "genericrgb.h"
+#include "imageview.h"
+#include "orientedview.h"
 
 #ifdef DAWFILTER_USEPYTHON
 #include <boost/python.hpp>
 #endif
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 
 namespace daw {
 	namespace imaging {
 		class FilterDAWGS {
 		public:
-			static GenericImage<rgb3> filter( GenericImage<rgb3> const &input_image );
+			// How the distinct too_gs keys of an image are found.  sort_unique sorts
+			// a copy of every key, bitset uses per thread presence bitsets and is
+			// linear in the number of pixels.  Both produce identical output
+			enum class key_engines : uint8_t { sort_unique = 0, bitset = 1 };
+
+			static GenericImage<rgb3>
+			filter( GenericImage<rgb3> const &input_image,
+			        key_engines const key_engine = key_engines::bitset );
+
+			// filter on the default TaskPool.  Chain further work, e.g. to_file, with
+			// then
+			static Future<GenericImage<rgb3>>
+			filter_async( GenericImage<rgb3> input_image,
+			              key_engines const key_engine = key_engines::bitset );
+
+			// Filter any row layout, e.g. a zero copy view of a FreeImage bitmap
+			// from make_view
+			static GenericImage<rgb3>
+			filter( ImageView<rgb3> const &input_image,
+			        key_engines const key_engine = key_engines::bitset );
+
+			// Filter a rotated or reflected view without materialising it.  The
+			// output is in the view's orientation
+			static GenericImage<rgb3>
+			filter( OrientedView<rgb3> const &input_image,
+			        key_engines const key_engine = key_engines::bitset );
+
+			// As filter, but returns a single channel 8bit image
+			static GenericImage<uint8_t>
+			filter_gs( GenericImage<rgb3> const &input_image,
+			           key_engines const key_engine = key_engines::bitset );
+
+			static GenericImage<uint8_t>
+			filter_gs( ImageView<rgb3> const &input_image,
+			           key_engines const key_engine = key_engines::bitset );
+
+			static GenericImage<uint8_t>
+			filter_gs( OrientedView<rgb3> const &input_image,
+			           key_engines const key_engine = key_engines::bitset );
+
+			// Planar input, keys are computed a block at a time from the channel
+			// planes.  Always uses the bitset key engine
+			static GenericImage<uint8_t>
+			filter_gs( PlanarImage<uint8_t> const &input_image );
+
+			// Read row_count top down rows starting at first_row into rows
+			using read_band_t =
+			  std::function<void( size_t first_row, size_t row_count, rgb3 *rows )>;
+			// Receives the 8bit output levels of row_count rows from first_row
+			using write_band_t = std::function<void(
+			  size_t first_row, size_t row_count, uint8_t const *levels )>;
+
+			static constexpr size_t default_band_rows = 256;
+
+			// Out of core filter.  The source is read twice, band_rows rows at a
+			// time.  The first pass collects the distinct keys, the second maps
+			// each band and hands it to write_band.  Peak memory is bounded by
+			// the band size and the key bitsets, not by the image size
+			static void filter_bands( size_t const width, size_t const height,
+			                          read_band_t const &read_band,
+			                          write_band_t const &write_band,
+			                          size_t const band_rows = default_band_rows );
+
+			// Streaming filter from a binary RGB netpbm (P6) file to a grayscale
+			// netpbm (P5) file
+			static void filter_netpbm( daw::string_view input_filename,
+			                           daw::string_view output_filename,
+			                           size_t const band_rows = default_band_rows );
 
 			static std::string description( ) {
 				return "Convert an RGB image to an optimized grayscale image";
 			}
 
+			static constexpr uint32_t too_gs( uint8_t const red, uint8_t const green,
+			                                  uint8_t const blue ) noexcept {
+				return 19595U * red + 38469U * green +
+				       7471U * blue; // 0.299r + 0.587g + 0.114b
+			}
+
 			static constexpr uint32_t too_gs( rgb3 const &pixel ) noexcept {
-				return 19595 * pixel.red + 38469 * pixel.green +
-				       7471 * pixel.blue; // 0.299r + 0.587g + 0.114b
+				return too_gs( pixel.red, pixel.green, pixel.blue );
 			}
 
 #ifdef DAWFILTER_USEPYTHON
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "future.h"
 #include "genericimage.h"
 #include "genericrgb.h"
 
@@ -36,6 +37,17 @@ namespace daw {
 		public:
 			static GenericImage<rgb3> filter( GenericImage<rgb3> const &input_image );
 
+			// filter on the default TaskPool
+			static Future<GenericImage<rgb3>>
+			filter_async( GenericImage<rgb3> input_image );
+
+			// As filter, but returns a single channel 8bit image
+			static GenericImage<uint8_t>
+			filter_gs( GenericImage<rgb3> const &input_image );
+
+			static GenericImage<uint8_t>
+			filter_gs( PlanarImage<uint8_t> const &input_image );
+
 			static std::string description( ) {
 				return "Convert an RGB image to an optimized grayscale image";
 			}
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include "future.h"
 #include "genericimage.h"
 #include "genericrgb.h"
+#include "repaintkernels.h"
 
 #ifdef DAWFILTER_USEPYTHON
 #include <boost/python.hpp>
@@ -48,6 +50,31 @@ namespace daw {
 			        FilterDAWGSColourize::repaint_formulas const repaint_formula =
 			          FilterDAWGSColourize::repaint_formulas::Ratio );
 
+			static GenericImage<rgb3>
+			filter( GenericImage<rgb3> const &input_image,
+			        GenericImage<uint8_t> const &input_gsimage,
+			        FilterDAWGSColourize::repaint_formulas const repaint_formula =
+			          FilterDAWGSColourize::repaint_formulas::Ratio );
+
+			// filter on the default TaskPool
+			static Future<GenericImage<rgb3>>
+			filter_async( GenericImage<rgb3> input_image,
+			              GenericImage<uint8_t> input_gsimage,
+			              FilterDAWGSColourize::repaint_formulas const repaint_formula =
+			                FilterDAWGSColourize::repaint_formulas::Ratio );
+
+			// Formula is one of the types in daw::imaging::repaint.  The repaint
+			// and normalisation passes are compiled for that formula only
+			template<typename Formula>
+			static GenericImage<rgb3>
+			filter( GenericImage<rgb3> const &input_image,
+			        GenericImage<rgb3> const &input_gsimage );
+
+			template<typename Formula>
+			static GenericImage<rgb3>
+			filter( GenericImage<rgb3> const &input_image,
+			        GenericImage<uint8_t> const &input_gsimage );
+
 			static std::unordered_map<std::string, repaint_formulas>
 			get_repaint_formulas( );
 
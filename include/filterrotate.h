@@ -22,14 +22,19 @@
 
 #pragma once
 
+#include "future.h"
 #include "genericimage.h"
 #include "genericrgb.h"
+#include "orientedview.h"
 
 #ifdef DAWFILTER_USEPYTHON
 #include <boost/python.hpp>
 #endif
+#include <cstdint>
 #include <string>
 
+#include <daw/daw_string_view.h>
+
 namespace daw {
 	namespace imaging {
 		class FilterRotate {
@@ -37,6 +42,32 @@ namespace daw {
 			static GenericImage<rgb3> filter( GenericImage<rgb3> const &image_input,
 			                                  uint32_t const angle );
 
+			// filter on the default TaskPool
+			static Future<GenericImage<rgb3>>
+			filter_async( GenericImage<rgb3> image_input, uint32_t const angle );
+
+			// The rotation as a view of image_input, nothing is copied.  Consumers
+			// that accept an OrientedView read the pixels in rotated order
+			static OrientedView<rgb3> view( GenericImage<rgb3> const &image_input,
+			                                uint32_t const angle );
+
+			// How filter_file rotated a file
+			enum class file_methods : uint8_t {
+				lossless_jpeg = 0,    // FreeImage_JPEGTransform, no decode
+				exif_orientation = 1, // Only the EXIF Orientation tag was changed
+				reencode = 2          // Decoded, rotated and encoded again
+			};
+
+			// Rotate an image file.  JPEG files are transformed losslessly when
+			// their dimensions are whole MCUs and they are not already oriented by
+			// EXIF.  Otherwise, when allow_exif is set and the file has an
+			// Orientation tag, only the tag is rewritten.  Anything else is
+			// decoded and saved through a rotated view
+			static file_methods filter_file( daw::string_view input_filename,
+			                                 daw::string_view output_filename,
+			                                 uint32_t const angle,
+			                                 bool const allow_exif = true );
+
 #ifdef DAWFILTER_USEPYTHON
 			static void
 			register_python( std::string const nameoftype = "filter_rotate" );
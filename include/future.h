@@ -0,0 +1,243 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "executor.h"
+#include "memoryaccounting.h"
+
+namespace daw {
+	namespace imaging {
+		template<typename T>
+		class Future;
+
+		// Run func on pool.  Its allocations count towards the caller's
+		// memory::scope
+		template<typename Func>
+		Future<std::invoke_result_t<Func>>
+		run_async( Func func, TaskPool &pool = default_task_pool( ) );
+
+		namespace impl {
+			// The value of a Future<void>
+			struct future_unit {};
+
+			template<typename T>
+			using future_storage_t =
+			  std::conditional_t<std::is_void_v<T>, future_unit, T>;
+
+			template<typename T>
+			class future_state {
+				std::mutex m_mutex;
+				std::condition_variable m_ready_cv;
+				std::optional<future_storage_t<T>> m_value;
+				std::exception_ptr m_error;
+				bool m_ready;
+				std::vector<std::function<void( )>> m_continuations;
+
+				void complete( ) {
+					std::vector<std::function<void( )>> continuations{};
+					{
+						std::lock_guard<std::mutex> lock( m_mutex );
+						m_ready = true;
+						continuations.swap( m_continuations );
+					}
+					m_ready_cv.notify_all( );
+					for( auto &continuation : continuations ) {
+						continuation( );
+					}
+				}
+
+			public:
+				future_state( )
+				  : m_mutex{}
+				  , m_ready_cv{}
+				  , m_value{}
+				  , m_error{}
+				  , m_ready{false}
+				  , m_continuations{} {}
+
+				void set_value( future_storage_t<T> value ) {
+					m_value = std::move( value );
+					complete( );
+				}
+
+				void set_error( std::exception_ptr error ) {
+					m_error = std::move( error );
+					complete( );
+				}
+
+				bool is_ready( ) {
+					std::lock_guard<std::mutex> lock( m_mutex );
+					return m_ready;
+				}
+
+				void wait( ) {
+					std::unique_lock<std::mutex> lock( m_mutex );
+					m_ready_cv.wait( lock, [this]( ) { return m_ready; } );
+				}
+
+				// The value or error is set once, before m_ready, and never changes
+				// afterwards, so it is read without the lock once ready
+				future_storage_t<T> const &value( ) {
+					wait( );
+					if( m_error ) {
+						std::rethrow_exception( m_error );
+					}
+					return *m_value;
+				}
+
+				// Run continuation on the thread that completes the state, or now
+				// if it is already complete
+				void on_ready( std::function<void( )> continuation ) {
+					{
+						std::lock_guard<std::mutex> lock( m_mutex );
+						if( !m_ready ) {
+							m_continuations.push_back( std::move( continuation ) );
+							return;
+						}
+					}
+					continuation( );
+				}
+			};
+
+			// What a continuation func returns when called with the value of a
+			// Future<T>
+			template<typename T, typename Func>
+			struct continuation_result {
+				using type = std::invoke_result_t<Func &, T const &>;
+			};
+
+			template<typename Func>
+			struct continuation_result<void, Func> {
+				using type = std::invoke_result_t<Func &>;
+			};
+
+			// Set state from the result of func, or from what it throws
+			template<typename T, typename Func>
+			void fulfil( future_state<T> &state, Func &func ) {
+				try {
+					if constexpr( std::is_void_v<T> ) {
+						func( );
+						state.set_value( future_unit{} );
+					} else {
+						state.set_value( func( ) );
+					}
+				} catch( ... ) { state.set_error( std::current_exception( ) ); }
+			}
+		} // namespace impl
+
+		// The result of work running on a TaskPool.  then chains a continuation
+		// that is queued on the pool once this result is ready, so no thread
+		// waits in between.  Errors skip the continuations and surface from get
+		template<typename T>
+		class Future {
+			std::shared_ptr<impl::future_state<T>> m_state;
+			TaskPool *m_pool;
+
+			template<typename Func>
+			friend Future<std::invoke_result_t<Func>> run_async( Func func,
+			                                                     TaskPool &pool );
+
+			template<typename U>
+			friend class Future;
+
+			Future( std::shared_ptr<impl::future_state<T>> state, TaskPool &pool )
+			  : m_state{std::move( state )}
+			  , m_pool{&pool} {}
+
+		public:
+			using value_type = T;
+
+			bool is_ready( ) const {
+				return m_state->is_ready( );
+			}
+
+			void wait( ) const {
+				m_state->wait( );
+			}
+
+			// Blocks until ready and rethrows the error, if any
+			decltype( auto ) get( ) const {
+				if constexpr( std::is_void_v<T> ) {
+					m_state->value( );
+				} else {
+					return m_state->value( );
+				}
+			}
+
+			// func( value ), or func( ) for Future<void>, once this is ready.  Its
+			// allocations count towards the caller's memory::scope
+			template<typename Func>
+			auto then( Func func ) const {
+				using result_t = typename impl::continuation_result<T, Func>::type;
+				auto next = std::make_shared<impl::future_state<result_t>>( );
+				auto state = m_state;
+				auto *const pool = m_pool;
+				auto account = memory::current_account( );
+				state->on_ready( [state, next, pool, account,
+				                  func = std::move( func )]( ) {
+					pool->add_task( [state, next, account, func]( ) mutable {
+						memory::scope_binding const binding( account );
+						auto call = [&]( ) -> result_t {
+							return invoke_with( func, state->value( ) );
+						};
+						impl::fulfil( *next, call );
+					} );
+				} );
+				return Future<result_t>( next, *pool );
+			}
+
+		private:
+			template<typename Func, typename Value>
+			static decltype( auto ) invoke_with( Func &func, Value const &value ) {
+				if constexpr( std::is_void_v<T> ) {
+					(void)value;
+					return func( );
+				} else {
+					return func( value );
+				}
+			}
+		};
+
+		template<typename Func>
+		Future<std::invoke_result_t<Func>> run_async( Func func, TaskPool &pool ) {
+			using result_t = std::invoke_result_t<Func>;
+			auto state = std::make_shared<impl::future_state<result_t>>( );
+			pool.add_task( [state, account = memory::current_account( ),
+			                func = std::move( func )]( ) mutable {
+				memory::scope_binding const binding( account );
+				impl::fulfil( *state, func );
+			} );
+			return Future<result_t>( state, pool );
+		}
+	} // namespace imaging
+} // namespace daw
@@ -31,42 +31,90 @@
 
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
-#include <vector>
 
 #include <daw/daw_exception.h>
-#include <daw/daw_random.h>
 #include <daw/daw_string_view.h>
 
 #include "fimage.h"
+#include "future.h"
 #include "genericrgb.h"
+#include "imagebuffer.h"
+#include "imageview.h"
+#include "orientedview.h"
 
 namespace daw {
 	namespace imaging {
-		template<class T>
+		// Storage policies for GenericImage.  packed_storage keeps whole pixels
+		// together, planar_storage keeps a separate buffer per channel so that
+		// channel math can use wide loads
+		struct packed_storage {};
+		struct planar_storage {};
+
+		template<class T, class Storage = packed_storage>
 		struct GenericImage {
+			static_assert( std::is_same<Storage, packed_storage>::value,
+			               "planar_storage is only available for GenericRGB pixels" );
+
 			using value_type = ::std::decay_t<T>;
-			using values_type = std::vector<value_type>;
-			using iterator = typename values_type::iterator;
-			using const_iterator = typename values_type::const_iterator;
-			using reference = typename values_type::reference;
-			using const_reference = typename values_type::const_reference;
+			using values_type = impl::ImageBuffer<value_type>;
+			using allocator_type = typename values_type::allocator_type;
+			using iterator = value_type *;
+			using const_iterator = value_type const *;
+			using reference = value_type &;
+			using const_reference = value_type const &;
 			using id_t = uint32_t;
 
 		private:
 			size_t m_width;
 			size_t m_height;
 			size_t m_size;
+			size_t m_stride;
 			size_t m_id;
 			values_type m_image_data;
 
-		public:
-			GenericImage( size_t width, size_t height )
+			GenericImage( size_t width, size_t height, row_padding padding,
+			              bool initialize, allocator_type const &alloc )
 			  : m_width{width}
 			  , m_height{height}
 			  , m_size{width * height}
-			  , m_id{daw::randint<id_t>( )}
-			  , m_image_data( width * height ) {}
+			  , m_stride{impl::row_stride<value_type>( width, padding )}
+			  , m_id{impl::next_image_id( )}
+			  , m_image_data( m_stride * height, initialize, alloc ) {}
+
+			value_type *contiguous_data( ) {
+				daw::exception::daw_throw_on_false(
+				  is_contiguous( ), "Cannot iterate an image with padded rows" );
+				return m_image_data.data( );
+			}
+
+			value_type const *contiguous_data( ) const {
+				daw::exception::daw_throw_on_false(
+				  is_contiguous( ), "Cannot iterate an image with padded rows" );
+				return m_image_data.data( );
+			}
+
+		public:
+			GenericImage( size_t width, size_t height,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, row_padding::none, true, alloc ) {}
+
+			GenericImage( size_t width, size_t height, no_init_t,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, row_padding::none, false, alloc ) {}
+
+			GenericImage( size_t width, size_t height, row_padding padding,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, padding, true, alloc ) {}
+
+			GenericImage( size_t width, size_t height, row_padding padding, no_init_t,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, padding, false, alloc ) {}
 
 			GenericImage( GenericImage const & ) = default;
 			GenericImage( GenericImage && ) noexcept = default;
@@ -87,58 +135,93 @@ namespace daw {
 				return m_size;
 			}
 
+			// Elements between the start of each row
+			size_t stride( ) const noexcept {
+				return m_stride;
+			}
+
+			// True when there is no row padding, so the pixels can be treated as
+			// one flat range of size( ) elements
+			bool is_contiguous( ) const noexcept {
+				return m_stride == m_width;
+			}
+
 			size_t id( ) const noexcept {
 				return m_id;
 			}
 
+			allocator_type get_allocator( ) const noexcept {
+				return m_image_data.get_allocator( );
+			}
+
 			const_reference operator( )( size_t const row, size_t const col ) const {
-				return arry( )[m_width * row + col];
+				return m_image_data.data( )[m_stride * row + col];
 			}
 
 			reference operator( )( size_t const row, size_t const col ) {
-				return arry( )[m_width * row + col];
+				return m_image_data.data( )[m_stride * row + col];
 			}
 
-		private:
-			values_type &arry( ) {
-				return m_image_data;
+			value_type const *row( size_t const y ) const noexcept {
+				return m_image_data.data( ) + m_stride * y;
 			}
 
-			values_type const &arry( ) const {
-				return m_image_data;
+			value_type *row( size_t const y ) noexcept {
+				return m_image_data.data( ) + m_stride * y;
 			}
 
-		public:
+			// Flat access, including any row padding
 			const_reference operator[]( size_t const pos ) const {
-				return arry( )[pos];
+				return m_image_data.data( )[pos];
 			}
 
 			reference operator[]( size_t const pos ) {
-				return arry( )[pos];
+				return m_image_data.data( )[pos];
+			}
+
+			// The pixels as one flat range.  Padded rows would put the padding in
+			// the range, so these throw unless is_contiguous( ).  Use row( y ) or
+			// view( ) for padded images
+			iterator begin( ) {
+				return contiguous_data( );
+			}
+
+			const_iterator begin( ) const {
+				return contiguous_data( );
+			}
+
+			const_iterator cbegin( ) const {
+				return contiguous_data( );
 			}
 
-			iterator begin( ) noexcept {
-				return m_image_data.begin( );
+			iterator end( ) {
+				return contiguous_data( ) + m_size;
 			}
 
-			const_iterator begin( ) const noexcept {
-				return m_image_data.begin( );
+			const_iterator end( ) const {
+				return contiguous_data( ) + m_size;
 			}
 
-			const_iterator cbegin( ) const noexcept {
-				return m_image_data.begin( );
+			const_iterator cend( ) const {
+				return contiguous_data( ) + m_size;
 			}
 
-			iterator end( ) noexcept {
-				return m_image_data.end( );
+			ImageView<value_type> view( ) const noexcept {
+				return ImageView<value_type>( m_image_data.data( ), m_width, m_height,
+				                              m_stride * sizeof( value_type ) );
 			}
 
-			const_iterator end( ) const noexcept {
-				return m_image_data.end( );
+			OrientedView<value_type> view( orientation const o ) const noexcept {
+				return OrientedView<value_type>( view( ), o );
 			}
 
-			const_iterator cend( ) const noexcept {
-				return m_image_data.end( );
+			// Only defined for GenericImage<uint8_t>, saved as an 8bpp grayscale
+			// (FIC_MINISBLACK) image
+			static void to_file( daw::string_view image_filename,
+			                     GenericImage const &image_input );
+
+			void to_file( daw::string_view image_filename ) const {
+				to_file( image_filename, *this );
 			}
 
 #ifdef DAWFILTER_USEPYTHON
@@ -158,117 +241,321 @@ namespace daw {
 #endif
 		};
 
+		template<>
+		void GenericImage<uint8_t>::to_file( daw::string_view image_filename,
+		                                     GenericImage<uint8_t> const &image_input );
+
 		template<>
 		struct GenericImage<rgb3> {
 			using value_type = rgb3;
-			using values_type = std::vector<value_type>;
-			using iterator = typename values_type::iterator;
-			using const_iterator = typename values_type::const_iterator;
-			using reference = typename values_type::reference;
-			using const_reference = typename values_type::const_reference;
+			using values_type = impl::ImageBuffer<value_type>;
+			using allocator_type = typename values_type::allocator_type;
+			using iterator = value_type *;
+			using const_iterator = value_type const *;
+			using reference = value_type &;
+			using const_reference = value_type const &;
 			using id_t = uint32_t;
 
 		private:
 			size_t m_width;
 			size_t m_height;
 			size_t m_size;
+			size_t m_stride;
 			size_t m_id;
 			values_type m_image_data;
 
-			inline values_type &arry( ) noexcept {
-				return m_image_data;
+			GenericImage( size_t width, size_t height, row_padding padding,
+			              bool initialize, allocator_type const &alloc )
+			  : m_width{width}
+			  , m_height{height}
+			  , m_size{width * height}
+			  , m_stride{impl::row_stride<value_type>( width, padding )}
+			  , m_id{impl::next_image_id( )}
+			  , m_image_data( m_stride * height, initialize, alloc ) {}
+
+			value_type *contiguous_data( ) {
+				daw::exception::daw_throw_on_false(
+				  is_contiguous( ), "Cannot iterate an image with padded rows" );
+				return m_image_data.data( );
 			}
 
-			inline values_type const &arry( ) const noexcept {
-				return m_image_data;
+			value_type const *contiguous_data( ) const {
+				daw::exception::daw_throw_on_false(
+				  is_contiguous( ), "Cannot iterate an image with padded rows" );
+				return m_image_data.data( );
 			}
 
 		public:
-			GenericImage( size_t const width, size_t const height )
-			  : m_width{width}
-			  , m_height{height}
-			  , m_size{width * height}
-			  , m_id{daw::randint<id_t>( )}
-			  , m_image_data( width * height ) {}
+			GenericImage( size_t width, size_t height,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, row_padding::none, true, alloc ) {}
+
+			GenericImage( size_t width, size_t height, no_init_t,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, row_padding::none, false, alloc ) {}
+
+			GenericImage( size_t width, size_t height, row_padding padding,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, padding, true, alloc ) {}
+
+			GenericImage( size_t width, size_t height, row_padding padding, no_init_t,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, padding, false, alloc ) {}
 
 			GenericImage( GenericImage const & ) = default;
 			GenericImage( GenericImage && ) noexcept = default;
-			GenericImage &operator=( GenericImage && ) noexcept = default;
 			GenericImage &operator=( GenericImage const & ) = default;
+			GenericImage &operator=( GenericImage && ) noexcept = default;
 
 			~GenericImage( ) = default;
 
 			static void to_file( daw::string_view image_filename,
 			                     GenericImage<rgb3> const &image_input );
 
+			// Save the view in its orientation without materialising it first
+			static void to_file( daw::string_view image_filename,
+			                     OrientedView<rgb3> const &image_input );
+
 			inline void to_file( daw::string_view image_filename ) const {
 				to_file( image_filename, *this );
 			}
 
 			static GenericImage<rgb3> from_file( daw::string_view image_filename );
 
-			inline size_t width( ) const noexcept {
+			size_t width( ) const noexcept {
 				return m_width;
 			}
 
-			inline size_t height( ) const noexcept {
+			size_t height( ) const noexcept {
 				return m_height;
 			}
 
-			inline size_t size( ) const noexcept {
+			size_t size( ) const noexcept {
 				return m_size;
 			}
 
-			inline size_t id( ) const noexcept {
+			// Elements between the start of each row
+			size_t stride( ) const noexcept {
+				return m_stride;
+			}
+
+			// True when there is no row padding, so the pixels can be treated as
+			// one flat range of size( ) elements
+			bool is_contiguous( ) const noexcept {
+				return m_stride == m_width;
+			}
+
+			size_t id( ) const noexcept {
 				return m_id;
 			}
 
-			const_reference operator( )( size_t const y, size_t const x ) const {
-				return arry( )[y * m_width + x];
+			allocator_type get_allocator( ) const noexcept {
+				return m_image_data.get_allocator( );
 			}
 
-			reference operator( )( size_t const y, size_t const x ) {
-				return arry( )[y * m_width + x];
+			const_reference operator( )( size_t const row, size_t const col ) const {
+				return m_image_data.data( )[m_stride * row + col];
 			}
 
+			reference operator( )( size_t const row, size_t const col ) {
+				return m_image_data.data( )[m_stride * row + col];
+			}
+
+			value_type const *row( size_t const y ) const noexcept {
+				return m_image_data.data( ) + m_stride * y;
+			}
+
+			value_type *row( size_t const y ) noexcept {
+				return m_image_data.data( ) + m_stride * y;
+			}
+
+			// Flat access, including any row padding
 			const_reference operator[]( size_t const pos ) const {
-				return arry( )[pos];
+				return m_image_data.data( )[pos];
 			}
 
 			reference operator[]( size_t const pos ) {
-				return arry( )[pos];
+				return m_image_data.data( )[pos];
 			}
 
-			iterator begin( ) noexcept {
-				return m_image_data.begin( );
+			// The pixels as one flat range.  Padded rows would put the padding in
+			// the range, so these throw unless is_contiguous( ).  Use row( y ) or
+			// view( ) for padded images
+			iterator begin( ) {
+				return contiguous_data( );
 			}
 
-			const_iterator begin( ) const noexcept {
-				return m_image_data.begin( );
+			const_iterator begin( ) const {
+				return contiguous_data( );
 			}
 
-			const_iterator cbegin( ) const noexcept {
-				return m_image_data.begin( );
+			const_iterator cbegin( ) const {
+				return contiguous_data( );
 			}
 
-			iterator end( ) noexcept {
-				return m_image_data.end( );
+			iterator end( ) {
+				return contiguous_data( ) + m_size;
 			}
 
-			const_iterator end( ) const noexcept {
-				return m_image_data.end( );
+			const_iterator end( ) const {
+				return contiguous_data( ) + m_size;
 			}
 
-			const_iterator cend( ) const noexcept {
-				return m_image_data.end( );
+			const_iterator cend( ) const {
+				return contiguous_data( ) + m_size;
 			}
+
+			ImageView<rgb3> view( ) const noexcept {
+				return ImageView<rgb3>( m_image_data.data( ), m_width, m_height,
+				                        m_stride * sizeof( value_type ) );
+			}
+
+			OrientedView<rgb3> view( orientation const o ) const noexcept {
+				return OrientedView<rgb3>( view( ), o );
+			}
+
+			static GenericImage<rgb3> from_view( ImageView<rgb3> const &image_view );
+
+			// Materialise the view in its orientation
+			static GenericImage<rgb3>
+			from_view( OrientedView<rgb3> const &image_view );
+
 #ifdef DAWFILTER_USEPYTHON
 			static void register_python( std::string const &nameoftype );
 #endif
 		};
 
+		template<typename T>
+		struct GenericImage<GenericRGB<T>, planar_storage> {
+			using value_type = GenericRGB<T>;
+			using channel_type = T;
+			using plane_type = impl::ImageBuffer<channel_type>;
+			using allocator_type = typename plane_type::allocator_type;
+			using id_t = uint32_t;
+
+		private:
+			size_t m_width;
+			size_t m_height;
+			size_t m_size;
+			size_t m_id;
+			plane_type m_red;
+			plane_type m_green;
+			plane_type m_blue;
+
+			GenericImage( size_t const width, size_t const height, bool initialize,
+			              allocator_type const &alloc )
+			  : m_width{width}
+			  , m_height{height}
+			  , m_size{width * height}
+			  , m_id{impl::next_image_id( )}
+			  , m_red( width * height, initialize, alloc )
+			  , m_green( width * height, initialize, alloc )
+			  , m_blue( width * height, initialize, alloc ) {}
+
+		public:
+			// Planes are never padded, each starts on a cache line boundary
+			GenericImage( size_t const width, size_t const height,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, true, alloc ) {}
+
+			GenericImage( size_t const width, size_t const height, no_init_t,
+			              allocator_type const &alloc =
+			                get_image_memory_resource( ) )
+			  : GenericImage( width, height, false, alloc ) {}
+
+			GenericImage( GenericImage const & ) = default;
+			GenericImage( GenericImage && ) noexcept = default;
+			GenericImage &operator=( GenericImage const & ) = default;
+			GenericImage &operator=( GenericImage && ) noexcept = default;
+
+			~GenericImage( ) = default;
+
+			size_t width( ) const noexcept {
+				return m_width;
+			}
+
+			size_t height( ) const noexcept {
+				return m_height;
+			}
+
+			size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			size_t id( ) const noexcept {
+				return m_id;
+			}
+
+			channel_type *red( ) noexcept {
+				return m_red.data( );
+			}
+
+			channel_type const *red( ) const noexcept {
+				return m_red.data( );
+			}
+
+			channel_type *green( ) noexcept {
+				return m_green.data( );
+			}
+
+			channel_type const *green( ) const noexcept {
+				return m_green.data( );
+			}
+
+			channel_type *blue( ) noexcept {
+				return m_blue.data( );
+			}
+
+			channel_type const *blue( ) const noexcept {
+				return m_blue.data( );
+			}
+
+			value_type operator[]( size_t const pos ) const noexcept {
+				return value_type( red( )[pos], green( )[pos], blue( )[pos] );
+			}
+
+			value_type operator( )( size_t const y, size_t const x ) const noexcept {
+				return operator[]( y * m_width + x );
+			}
+
+			void set( size_t const pos, value_type const &value ) noexcept {
+				red( )[pos] = value.red;
+				green( )[pos] = value.green;
+				blue( )[pos] = value.blue;
+			}
+		};
+
+		template<typename T>
+		using PlanarImage = GenericImage<GenericRGB<T>, planar_storage>;
+
+		// Conversions between packed and planar layouts
+		PlanarImage<uint8_t> to_planar( GenericImage<rgb3> const &image_input );
+		GenericImage<rgb3> to_packed( PlanarImage<uint8_t> const &image_input );
+
 		inline GenericImage<rgb3> from_file( daw::string_view image_filename ) {
 			return GenericImage<rgb3>::from_file( image_filename );
 		}
+
+		// from_file on the default TaskPool
+		inline Future<GenericImage<rgb3>>
+		from_file_async( std::string image_filename ) {
+			return run_async( [image_filename = std::move( image_filename )]( ) {
+				return from_file( image_filename );
+			} );
+		}
+
+		// Load an image file into a 24bpp or 32bpp RGB FreeImage bitmap
+		FreeImage load_bitmap( daw::string_view image_filename );
+
+		// A zero copy view of a bitmap's pixels.  32bpp bitmaps are first
+		// converted to 24bpp in place.  Where FreeImage's byte order is not
+		// rgb3's the pixels are also reordered in place, so the bitmap no longer
+		// holds FreeImage order.  The bitmap must outlive the view
+		ImageView<rgb3> make_view( FreeImage &bitmap );
 	} // namespace imaging
 } // namespace daw
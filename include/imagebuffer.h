@@ -0,0 +1,234 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "memoryaccounting.h"
+
+namespace daw {
+	namespace imaging {
+		// Pass to a GenericImage constructor to leave the pixels uninitialized
+		// when every pixel is about to be overwritten
+		struct no_init_t {
+			explicit no_init_t( ) = default;
+		};
+		constexpr no_init_t no_init{};
+
+		// Row padding of an image.  cache_line pads every row so that each row
+		// starts on a cache line boundary
+		enum class row_padding : uint8_t { none = 0, cache_line = 1 };
+
+		constexpr size_t cache_line_size = 64;
+
+		// The memory resource image buffers and filter temporaries are allocated
+		// from when no allocator is given.  Defaults to
+		// memory::counting_resource( ), the heap with memory accounting, and
+		// passing nullptr selects it again.  Pass &default_image_pool( ) to
+		// reuse buffers when processing many images
+		std::pmr::memory_resource *get_image_memory_resource( ) noexcept;
+		void
+		set_image_memory_resource( std::pmr::memory_resource *resource ) noexcept;
+
+		// Allocates from the image memory resource current when it was created.
+		// Unlike a pmr allocator, copies of a container use the same resource
+		template<typename T>
+		class image_allocator {
+			std::pmr::memory_resource *m_resource;
+
+		public:
+			using value_type = T;
+			using propagate_on_container_copy_assignment = std::true_type;
+			using propagate_on_container_move_assignment = std::true_type;
+			using propagate_on_container_swap = std::true_type;
+
+			image_allocator( ) noexcept
+			  : m_resource{get_image_memory_resource( )} {}
+
+			template<typename U>
+			image_allocator( image_allocator<U> const &other ) noexcept
+			  : m_resource{other.resource( )} {}
+
+			T *allocate( size_t const n ) {
+				return static_cast<T *>(
+				  m_resource->allocate( n * sizeof( T ), alignof( T ) ) );
+			}
+
+			void deallocate( T *const p, size_t const n ) noexcept {
+				m_resource->deallocate( p, n * sizeof( T ), alignof( T ) );
+			}
+
+			std::pmr::memory_resource *resource( ) const noexcept {
+				return m_resource;
+			}
+		};
+
+		template<typename T, typename U>
+		bool operator==( image_allocator<T> const &lhs,
+		                 image_allocator<U> const &rhs ) noexcept {
+			return lhs.resource( )->is_equal( *rhs.resource( ) );
+		}
+
+		template<typename T, typename U>
+		bool operator!=( image_allocator<T> const &lhs,
+		                 image_allocator<U> const &rhs ) noexcept {
+			return !( lhs == rhs );
+		}
+
+		// Temporary buffers of the filters, e.g. bands and key sets
+		template<typename T>
+		using image_vector = std::vector<T, image_allocator<T>>;
+
+		namespace impl {
+			inline uint32_t next_image_id( ) noexcept {
+				static std::atomic<uint32_t> s_id{0};
+				return s_id.fetch_add( 1, std::memory_order_relaxed );
+			}
+
+			// Number of elements between the start of each row
+			template<typename T>
+			constexpr size_t row_stride( size_t const width,
+			                             row_padding const padding ) noexcept {
+				if( padding == row_padding::none ) {
+					return width;
+				}
+				// Smallest element count whose size is a multiple of a cache line
+				auto const step = cache_line_size / std::gcd( sizeof( T ), cache_line_size );
+				return ( ( width + step - 1 ) / step ) * step;
+			}
+
+			// Cache line aligned storage for trivially copyable pixels, allocated
+			// from a std::pmr::memory_resource
+			template<typename T>
+			class ImageBuffer {
+				static_assert( std::is_trivially_copyable<T>::value &&
+				                 std::is_trivially_destructible<T>::value,
+				               "Image pixels must be trivially copyable" );
+
+			public:
+				using value_type = T;
+				using allocator_type = std::pmr::polymorphic_allocator<T>;
+				static constexpr size_t alignment = std::max( cache_line_size, alignof( T ) );
+
+			private:
+				std::pmr::memory_resource *m_resource;
+				T *m_data;
+				size_t m_size;
+
+				T *allocate( ) {
+					if( 0 == m_size ) {
+						return nullptr;
+					}
+					return static_cast<T *>(
+					  m_resource->allocate( m_size * sizeof( T ), alignment ) );
+				}
+
+				void deallocate( ) noexcept {
+					if( nullptr != m_data ) {
+						m_resource->deallocate( m_data, m_size * sizeof( T ), alignment );
+						m_data = nullptr;
+					}
+				}
+
+			public:
+				ImageBuffer( size_t const size, bool const initialize,
+				             allocator_type const &alloc )
+				  : m_resource{alloc.resource( )}
+				  , m_data{nullptr}
+				  , m_size{size} {
+
+					m_data = allocate( );
+					if( initialize ) {
+						std::uninitialized_fill_n( m_data, m_size, T{} );
+					}
+				}
+
+				// Copies are allocated from the same memory resource as the original
+				ImageBuffer( ImageBuffer const &other )
+				  : m_resource{other.m_resource}
+				  , m_data{nullptr}
+				  , m_size{other.m_size} {
+
+					m_data = allocate( );
+					std::uninitialized_copy_n( other.m_data, m_size, m_data );
+				}
+
+				ImageBuffer( ImageBuffer &&other ) noexcept
+				  : m_resource{other.m_resource}
+				  , m_data{std::exchange( other.m_data, nullptr )}
+				  , m_size{std::exchange( other.m_size, 0 )} {}
+
+				ImageBuffer &operator=( ImageBuffer const &rhs ) {
+					if( this != &rhs ) {
+						ImageBuffer tmp{rhs};
+						swap( tmp );
+					}
+					return *this;
+				}
+
+				ImageBuffer &operator=( ImageBuffer &&rhs ) noexcept {
+					if( this != &rhs ) {
+						ImageBuffer tmp{std::move( rhs )};
+						swap( tmp );
+					}
+					return *this;
+				}
+
+				~ImageBuffer( ) noexcept {
+					deallocate( );
+				}
+
+				void swap( ImageBuffer &other ) noexcept {
+					std::swap( m_resource, other.m_resource );
+					std::swap( m_data, other.m_data );
+					std::swap( m_size, other.m_size );
+				}
+
+				allocator_type get_allocator( ) const noexcept {
+					return allocator_type{m_resource};
+				}
+
+				T *data( ) noexcept {
+					return m_data;
+				}
+
+				T const *data( ) const noexcept {
+					return m_data;
+				}
+
+				size_t size( ) const noexcept {
+					return m_size;
+				}
+			};
+		} // namespace impl
+	}   // namespace imaging
+} // namespace daw
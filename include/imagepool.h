@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace daw {
+	namespace imaging {
+		// A thread safe memory_resource that caches freed image buffers by size
+		// class so that repeatedly processing same sized images does not go
+		// back to the heap.  Size classes are 4 per power of two, so a cached
+		// buffer is at most 25% larger than requested.  Once max_cached_bytes are
+		// cached, freed buffers go back to the upstream resource
+		class ImagePool : public std::pmr::memory_resource {
+		public:
+			struct statistics {
+				size_t hits;
+				size_t misses;
+				size_t cached_bytes;
+			};
+
+			// 128MiB, e.g. three 4096x3072 rgb3 images
+			static constexpr size_t default_max_cached_bytes = 1ULL << 27U;
+
+		private:
+			std::pmr::memory_resource *m_upstream;
+			size_t m_max_cached_bytes;
+			mutable std::mutex m_mutex;
+			std::unordered_map<size_t, std::vector<void *>> m_free_lists;
+			size_t m_cached_bytes;
+			std::atomic<size_t> m_hits;
+			std::atomic<size_t> m_misses;
+
+			void *do_allocate( size_t bytes, size_t alignment ) override;
+			void do_deallocate( void *p, size_t bytes, size_t alignment ) override;
+			bool do_is_equal( std::pmr::memory_resource const &other ) const
+			  noexcept override;
+
+		public:
+			explicit ImagePool(
+			  size_t max_cached_bytes = default_max_cached_bytes,
+			  std::pmr::memory_resource *upstream = std::pmr::new_delete_resource( ) );
+
+			ImagePool( ImagePool const & ) = delete;
+			ImagePool &operator=( ImagePool const & ) = delete;
+
+			~ImagePool( ) override;
+
+			// Bytes actually allocated for a request of bytes
+			static size_t size_class( size_t bytes ) noexcept;
+
+			statistics stats( ) const;
+
+			// Return all cached buffers to the upstream resource
+			void release( );
+		};
+
+		// A process wide pool for set_image_memory_resource, image buffers do not
+		// use it unless it is selected.  It allocates from
+		// memory::counting_resource( ) and keeps at most default_max_cached_bytes
+		// until release( )
+		ImagePool &default_image_pool( );
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace daw {
+	namespace imaging {
+		// Non-owning read only view of pixels laid out in rows.  Rows are pitch
+		// bytes apart and may be stored bottom up, as FreeImage does.  Row 0 is
+		// always the top row
+		template<typename T>
+		class ImageView {
+		public:
+			using value_type = T;
+			using const_reference = value_type const &;
+
+		private:
+			uint8_t const *m_data;
+			size_t m_width;
+			size_t m_height;
+			size_t m_pitch;
+			bool m_bottom_up;
+
+		public:
+			constexpr ImageView( T const *data, size_t const width,
+			                     size_t const height, size_t const pitch,
+			                     bool const bottom_up = false ) noexcept
+			  : m_data{reinterpret_cast<uint8_t const *>( data )}
+			  , m_width{width}
+			  , m_height{height}
+			  , m_pitch{pitch}
+			  , m_bottom_up{bottom_up} {}
+
+			constexpr size_t width( ) const noexcept {
+				return m_width;
+			}
+
+			constexpr size_t height( ) const noexcept {
+				return m_height;
+			}
+
+			constexpr size_t size( ) const noexcept {
+				return m_width * m_height;
+			}
+
+			constexpr size_t pitch( ) const noexcept {
+				return m_pitch;
+			}
+
+			constexpr bool bottom_up( ) const noexcept {
+				return m_bottom_up;
+			}
+
+			// True when all pixels are one top down contiguous range starting at
+			// row( 0 )
+			constexpr bool is_contiguous( ) const noexcept {
+				return m_pitch == m_width * sizeof( T ) && ( !m_bottom_up || m_height <= 1 );
+			}
+
+			T const *row( size_t const y ) const noexcept {
+				auto const pos = m_bottom_up ? m_height - 1 - y : y;
+				return reinterpret_cast<T const *>( m_data + pos * m_pitch );
+			}
+
+			const_reference operator( )( size_t const y, size_t const x ) const
+			  noexcept {
+				return row( y )[x];
+			}
+		};
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,139 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+// Accounting of the memory used by image buffers and filter temporaries.
+//
+//   memory::scope const mem{};
+//   auto const out = FilterDAWGS::filter( image );
+//   auto const peak = mem.get_usage( ).peak_bytes;
+//
+// Only memory allocated from counting_resource( ) is counted, not general
+// heap use.  The default image memory resource and default_image_pool( )
+// both allocate from it.  Two limits follow from counting there:
+//
+// - A resource given to set_image_memory_resource is only counted if it
+//   allocates from counting_resource( ) in turn.
+// - Behind a pool, what is counted is what the pool takes from the heap.  A
+//   buffer served from the pool's cache is not counted again, and a buffer
+//   the pool keeps cached still counts towards the scope that first
+//   allocated it until the pool releases it
+namespace daw {
+	namespace imaging {
+		namespace memory {
+			struct usage {
+				// Bytes allocated less bytes freed since the scope began
+				int64_t current_bytes;
+				// Highest value current_bytes reached
+				int64_t peak_bytes;
+				uint64_t allocated_bytes;
+				uint64_t allocation_count;
+			};
+
+			// The counters of a scope.  Every allocation holds on to the account
+			// it was made in, so freeing it is counted there, whichever thread
+			// frees it and even after the scope has ended.  An allocation counts
+			// towards its account and every enclosing one
+			class account {
+				std::shared_ptr<account> m_parent;
+				std::atomic<int64_t> m_current{0};
+				std::atomic<int64_t> m_peak{0};
+				std::atomic<uint64_t> m_allocated{0};
+				std::atomic<uint64_t> m_allocations{0};
+
+			public:
+				explicit account( std::shared_ptr<account> parent ) noexcept;
+
+				account( account const & ) = delete;
+				account &operator=( account const & ) = delete;
+
+				usage get_usage( ) const noexcept;
+
+				void add_allocation( size_t const bytes ) noexcept;
+				void add_deallocation( size_t const bytes ) noexcept;
+			};
+
+			using account_ptr = std::shared_ptr<account>;
+
+			// The account allocations on this thread count towards, nullptr when
+			// there is none
+			account_ptr const &current_account( ) noexcept;
+
+			// Counts allocations while it is current.  A scope is current on the
+			// thread that creates it until it is destroyed.  The filters' parallel
+			// loops and run_async carry it to the threads doing the work.  Scopes
+			// nest, destroy them in reverse order of creation
+			class scope {
+				account_ptr m_account;
+				account_ptr m_previous;
+
+			public:
+				scope( );
+				~scope( );
+
+				scope( scope const & ) = delete;
+				scope &operator=( scope const & ) = delete;
+
+				usage get_usage( ) const noexcept {
+					return m_account->get_usage( );
+				}
+			};
+
+			// Makes an account, or nullptr for none, current on this thread until
+			// destroyed
+			class scope_binding {
+				account_ptr m_previous;
+
+			public:
+				explicit scope_binding( account_ptr current ) noexcept;
+				~scope_binding( );
+
+				scope_binding( scope_binding const & ) = delete;
+				scope_binding &operator=( scope_binding const & ) = delete;
+			};
+
+			// Heap memory counted towards the current account when allocated
+			std::pmr::memory_resource *counting_resource( ) noexcept;
+
+			// Counts memory allocated outside of the library, e.g. a FreeImage
+			// bitmap, for its lifetime
+			class external_allocation {
+				account_ptr m_account;
+				size_t m_bytes;
+
+			public:
+				explicit external_allocation( size_t const bytes ) noexcept;
+				~external_allocation( );
+
+				external_allocation( external_allocation const & ) = delete;
+				external_allocation &operator=( external_allocation const & ) = delete;
+			};
+		} // namespace memory
+	}   // namespace imaging
+} // namespace daw
@@ -0,0 +1,83 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include <daw/daw_string_view.h>
+
+#include "genericrgb.h"
+
+namespace daw {
+	namespace imaging {
+		// Random access reader for binary 8bit RGB netpbm (P6) files.  Only the
+		// requested rows are read so images can be processed in bands without
+		// loading them whole
+		class NetpbmReader {
+			std::string m_filename;
+			std::ifstream m_file;
+			size_t m_width;
+			size_t m_height;
+			std::streamoff m_data_offset;
+
+		public:
+			explicit NetpbmReader( daw::string_view filename );
+
+			inline size_t width( ) const noexcept {
+				return m_width;
+			}
+
+			inline size_t height( ) const noexcept {
+				return m_height;
+			}
+
+			// Read row_count rows, top down, starting at first_row into rows
+			void read_rows( size_t const first_row, size_t const row_count,
+			                rgb3 *rows );
+		};
+
+		// Writer for binary 8bit grayscale netpbm (P5) files.  Rows can be
+		// written in any order
+		class NetpbmWriter {
+			std::string m_filename;
+			std::ofstream m_file;
+			size_t m_width;
+			size_t m_height;
+			std::streamoff m_data_offset;
+
+		public:
+			NetpbmWriter( daw::string_view filename, size_t const width,
+			              size_t const height );
+
+			void write_rows( size_t const first_row, size_t const row_count,
+			                 uint8_t const *levels );
+
+			// Flush and close the file once every row is written.  Throws if any
+			// of it could not be written
+			void close( );
+		};
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,227 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "imageview.h"
+
+namespace daw {
+	namespace imaging {
+		// The eight rotations and reflections of an image.  Each is stored as
+		// whether the axes are swapped and whether the output columns and rows
+		// are then mirrored.  Rotations are clockwise
+		enum class orientation : uint8_t {
+			identity = 0,
+			transpose = 1,
+			flip_horizontal = 2,
+			rotate_90 = 3,
+			flip_vertical = 4,
+			rotate_270 = 5,
+			rotate_180 = 6,
+			transverse = 7
+		};
+
+		namespace impl {
+			constexpr bool swaps_axes( orientation const o ) noexcept {
+				return ( static_cast<uint8_t>( o ) & 1U ) != 0;
+			}
+
+			constexpr bool flips_x( orientation const o ) noexcept {
+				return ( static_cast<uint8_t>( o ) & 2U ) != 0;
+			}
+
+			constexpr bool flips_y( orientation const o ) noexcept {
+				return ( static_cast<uint8_t>( o ) & 4U ) != 0;
+			}
+
+			constexpr orientation make_orientation( bool const swap, bool const fx,
+			                                        bool const fy ) noexcept {
+				return static_cast<orientation>( ( swap ? 1U : 0U ) |
+				                                 ( fx ? 2U : 0U ) | ( fy ? 4U : 0U ) );
+			}
+		} // namespace impl
+
+		// The orientation of applying first and then second
+		constexpr orientation compose( orientation const first,
+		                               orientation const second ) noexcept {
+			// Mirroring before a swap of the axes mirrors the other axis after it
+			auto const second_swaps = impl::swaps_axes( second );
+			auto const fx =
+			  ( second_swaps ? impl::flips_y( first ) : impl::flips_x( first ) ) !=
+			  impl::flips_x( second );
+			auto const fy =
+			  ( second_swaps ? impl::flips_x( first ) : impl::flips_y( first ) ) !=
+			  impl::flips_y( second );
+			return impl::make_orientation(
+			  impl::swaps_axes( first ) != second_swaps, fx, fy );
+		}
+
+		// Clockwise rotation by quarter_turns * 90 degrees
+		constexpr orientation rotation( uint32_t const quarter_turns ) noexcept {
+			switch( quarter_turns % 4 ) {
+			case 1:
+				return orientation::rotate_90;
+			case 2:
+				return orientation::rotate_180;
+			case 3:
+				return orientation::rotate_270;
+			default:
+				return orientation::identity;
+			}
+		}
+
+		// An ImageView read through a rotation or reflection.  Nothing is copied,
+		// operator( ) maps each pixel back to the source and copy_rows gathers
+		// whole rows for consumers that need contiguous memory.  The source must
+		// outlive the view
+		template<typename T>
+		class OrientedView {
+		public:
+			using value_type = T;
+			using const_reference = value_type const &;
+
+			// Rows gathered at a time by consumers that need contiguous memory
+			static constexpr size_t band_rows = 16;
+
+		private:
+			ImageView<T> m_source;
+			orientation m_orientation;
+
+			size_t source_x( size_t const y, size_t const x ) const noexcept {
+				auto const sx = impl::swaps_axes( m_orientation ) ? y : x;
+				return flips_source_x( ) ? m_source.width( ) - 1 - sx : sx;
+			}
+
+			size_t source_y( size_t const y, size_t const x ) const noexcept {
+				auto const sy = impl::swaps_axes( m_orientation ) ? x : y;
+				return flips_source_y( ) ? m_source.height( ) - 1 - sy : sy;
+			}
+
+			// Whether source columns/rows are read in reverse
+			bool flips_source_x( ) const noexcept {
+				auto const o = m_orientation;
+				return impl::swaps_axes( o ) ? impl::flips_y( o ) : impl::flips_x( o );
+			}
+
+			bool flips_source_y( ) const noexcept {
+				auto const o = m_orientation;
+				return impl::swaps_axes( o ) ? impl::flips_x( o ) : impl::flips_y( o );
+			}
+
+		public:
+			constexpr OrientedView(
+			  ImageView<T> const &source,
+			  orientation const o = orientation::identity ) noexcept
+			  : m_source{source}
+			  , m_orientation{o} {}
+
+			constexpr ImageView<T> const &source( ) const noexcept {
+				return m_source;
+			}
+
+			constexpr orientation get_orientation( ) const noexcept {
+				return m_orientation;
+			}
+
+			constexpr bool is_identity( ) const noexcept {
+				return m_orientation == orientation::identity;
+			}
+
+			constexpr size_t width( ) const noexcept {
+				return impl::swaps_axes( m_orientation ) ? m_source.height( )
+				                                         : m_source.width( );
+			}
+
+			constexpr size_t height( ) const noexcept {
+				return impl::swaps_axes( m_orientation ) ? m_source.width( )
+				                                         : m_source.height( );
+			}
+
+			constexpr size_t size( ) const noexcept {
+				return m_source.size( );
+			}
+
+			const_reference operator( )( size_t const y, size_t const x ) const
+			  noexcept {
+				return m_source( source_y( y, x ), source_x( y, x ) );
+			}
+
+			// The same source seen through a further rotation or reflection
+			constexpr OrientedView then( orientation const o ) const noexcept {
+				return OrientedView( m_source, compose( m_orientation, o ) );
+			}
+
+			constexpr OrientedView rotated( uint32_t const quarter_turns ) const
+			  noexcept {
+				return then( rotation( quarter_turns ) );
+			}
+
+			constexpr OrientedView flipped_horizontal( ) const noexcept {
+				return then( orientation::flip_horizontal );
+			}
+
+			constexpr OrientedView flipped_vertical( ) const noexcept {
+				return then( orientation::flip_vertical );
+			}
+
+			constexpr OrientedView transposed( ) const noexcept {
+				return then( orientation::transpose );
+			}
+
+			// Copy rows [first_row, first_row + row_count) top down into out, with
+			// out_stride elements between the starts of the output rows.  When the
+			// axes are swapped each output row is a source column, so the band is
+			// filled a source row at a time to keep the reads sequential
+			void copy_rows( size_t const first_row, size_t const row_count, T *out,
+			                size_t const out_stride ) const {
+				auto const out_width = width( );
+				if( !impl::swaps_axes( m_orientation ) ) {
+					for( size_t r = 0; r < row_count; ++r ) {
+						auto const *row = m_source.row( source_y( first_row + r, 0 ) );
+						auto *dst = out + r * out_stride;
+						if( flips_source_x( ) ) {
+							std::reverse_copy( row, row + out_width, dst );
+						} else {
+							std::copy_n( row, out_width, dst );
+						}
+					}
+					return;
+				}
+				for( size_t c = 0; c < out_width; ++c ) {
+					auto const *row = m_source.row( source_y( 0, c ) );
+					for( size_t r = 0; r < row_count; ++r ) {
+						out[r * out_stride + c] = row[source_x( first_row + r, c )];
+					}
+				}
+			}
+
+			void copy_rows( size_t const first_row, size_t const row_count,
+			                T *out ) const {
+				copy_rows( first_row, row_count, out, width( ) );
+			}
+		};
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <daw/fs/algorithms.h>
+
+#include "memoryaccounting.h"
+
+namespace daw {
+	namespace imaging {
+		namespace impl {
+			inline std::atomic<size_t> &thread_limit_storage( ) noexcept {
+				static std::atomic<size_t> limit{0};
+				return limit;
+			}
+		} // namespace impl
+
+		// Caps the number of chunks the filters split their work into, and so
+		// the number of threads working on one image.  Zero, the default, uses
+		// every hardware thread
+		inline void set_thread_limit( size_t const limit ) noexcept {
+			impl::thread_limit_storage( ).store( limit );
+		}
+
+		inline size_t thread_limit( ) noexcept {
+			return impl::thread_limit_storage( ).load( );
+		}
+
+		namespace impl {
+			inline size_t max_chunk_count( ) noexcept {
+				auto const hw = std::thread::hardware_concurrency( );
+				auto const threads = hw == 0 ? 1 : static_cast<size_t>( hw );
+				auto const limit = thread_limit( );
+				return limit == 0 ? threads : std::min( threads, limit );
+			}
+
+			// Number of chunks to split item_count items into so that no chunk is
+			// smaller than min_chunk_size, capped at the number of hardware threads
+			inline size_t chunk_count( size_t const item_count,
+			                           size_t const min_chunk_size ) noexcept {
+				auto const chunks =
+				  item_count / std::max( min_chunk_size, static_cast<size_t>( 1 ) );
+				return std::max( static_cast<size_t>( 1 ),
+				                 std::min( chunks, max_chunk_count( ) ) );
+			}
+
+			// Split [0, item_count) into chunks contiguous ranges and call
+			// func( chunk_index, first, last ) for each of them in parallel.  Chunk
+			// boundaries depend only on item_count and chunks, so per chunk results
+			// can be combined deterministically afterwards.  Allocations made by
+			// func count towards the caller's memory::scope
+			template<typename Func>
+			void for_each_chunk( size_t const item_count, size_t const chunks,
+			                     Func func ) {
+				if( chunks <= 1 || item_count < 2 ) {
+					func( static_cast<size_t>( 0 ), static_cast<size_t>( 0 ),
+					      item_count );
+					return;
+				}
+				std::vector<size_t> chunk_ids( chunks );
+				std::iota( chunk_ids.begin( ), chunk_ids.end( ),
+				           static_cast<size_t>( 0 ) );
+
+				auto const &memory_account = memory::current_account( );
+				daw::algorithm::parallel::for_each(
+				  chunk_ids.begin( ), chunk_ids.end( ), [&]( size_t const chunk ) {
+					  memory::scope_binding const binding( memory_account );
+					  auto const first = ( item_count * chunk ) / chunks;
+					  auto const last = ( item_count * ( chunk + 1 ) ) / chunks;
+					  func( chunk, first, last );
+				  } );
+			}
+		} // namespace impl
+	}   // namespace imaging
+} // namespace daw
@@ -0,0 +1,166 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <daw/daw_string_view.h>
+
+#include "filterdawgscolourize.h"
+#include "genericimage.h"
+#include "genericrgb.h"
+#include "imageview.h"
+#include "orientedview.h"
+
+namespace daw {
+	namespace imaging {
+		// A lazy chain of filters that is executed a band of rows at a time.  A
+		// band is sized to stay in L2 while every point wise stage runs over it,
+		// so no stage allocates or streams a whole intermediate image.
+		//
+		// Stages that need the whole image before they can map a pixel, such as
+		// the DAWGS key set, the DAWGS2 channel means or the colourize range, are
+		// reduction barriers.  Each barrier costs one extra pass over the source
+		// in which the stages before it feed its reduction; it then becomes a
+		// point wise stage.  pass_count( ) reports the passes a run will take.
+		//
+		// The source must outlive the pipeline
+		class Pipeline {
+		public:
+			// Band of row_count rows of width pixels starting at first_row of the
+			// output, stored contiguously
+			struct band {
+				size_t first_row;
+				size_t row_count;
+				size_t width;
+				rgb3 *pixels;
+
+				size_t size( ) const noexcept {
+					return row_count * width;
+				}
+			};
+
+			// A point wise stage, maps the band in place
+			using map_t = std::function<void( band const & )>;
+
+			// A stage that needs global information.  begin is called with the
+			// number of chunks of a pass, then every band is accumulated by the
+			// chunk that processed it, possibly in parallel with other chunks.
+			// finish merges the partials and returns the map that replaces the
+			// barrier
+			class Reduction {
+			public:
+				Reduction( ) = default;
+				Reduction( Reduction const & ) = delete;
+				Reduction &operator=( Reduction const & ) = delete;
+				virtual ~Reduction( );
+
+				virtual void begin( size_t const chunks ) = 0;
+				virtual void accumulate( size_t const chunk, band const &pixels ) = 0;
+				virtual map_t finish( ) = 0;
+			};
+
+			// Bytes of pixels in a band
+			static constexpr size_t default_band_bytes = 256U * 1024U;
+
+		private:
+			struct stage {
+				map_t map;
+				std::shared_ptr<Reduction> reduction;
+			};
+
+			OrientedView<rgb3> m_source;
+			std::vector<stage> m_stages;
+			size_t m_band_bytes;
+
+			size_t band_rows( ) const noexcept;
+			size_t band_count( ) const noexcept;
+			size_t chunk_count( ) const noexcept;
+
+			// Push every band through maps and hand it to consume.  When output is
+			// not null the bands are built in place in it
+			void run_pass( std::vector<map_t> const &maps,
+			               std::function<void( size_t chunk, band const & )> const
+			                 &consume,
+			               rgb3 *const output ) const;
+
+			// Run a pass for each barrier and return the point wise maps of all
+			// stages
+			std::vector<map_t> resolve( );
+
+		public:
+			explicit Pipeline( OrientedView<rgb3> const &source,
+			                   size_t const band_bytes = default_band_bytes );
+
+			explicit Pipeline( ImageView<rgb3> const &source,
+			                   size_t const band_bytes = default_band_bytes );
+
+			size_t width( ) const noexcept {
+				return m_source.width( );
+			}
+
+			size_t height( ) const noexcept {
+				return m_source.height( );
+			}
+
+			// One pass for the output plus one per reduction barrier
+			size_t pass_count( ) const noexcept;
+
+			// Rotations and reflections are fused into how the source is read, so
+			// they must come before any other stage
+			Pipeline &orient( orientation const o );
+			Pipeline &rotate( uint32_t const angle );
+
+			Pipeline &map( map_t stage_map );
+			Pipeline &reduce( std::shared_ptr<Reduction> reduction );
+
+			// FilterDAWGS::filter, a barrier on the distinct keys
+			Pipeline &dawgs( );
+
+			// FilterDAWGS2::filter, a barrier on the channel sums
+			Pipeline &dawgs2( );
+
+			// FilterDAWGSColourize::filter with the current pixels as the input
+			// image, a barrier on the repainted range.  input_gsimage must be the
+			// size of the output and outlive the pipeline
+			Pipeline &
+			colourize( GenericImage<uint8_t> const &input_gsimage,
+			           FilterDAWGSColourize::repaint_formulas const repaint_formula =
+			             FilterDAWGSColourize::repaint_formulas::Ratio );
+
+			// Running uses the reductions' state, a pipeline can only run on one
+			// thread at a time
+			GenericImage<rgb3> run( );
+
+			// The red channel of the output.  Use after a stage with gray output
+			// such as dawgs or dawgs2
+			GenericImage<uint8_t> run_gs( );
+
+			void to_file( daw::string_view image_filename );
+		};
+	} // namespace imaging
+} // namespace daw
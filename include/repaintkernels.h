@@ -0,0 +1,486 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <daw/daw_math.h>
+
+#include "genericrgb.h"
+#include "imagebuffer.h"
+
+namespace daw {
+	namespace imaging {
+		namespace impl {
+			// The repaint formulas of FilterDAWGSColourize.  Each maps an original
+			// pixel and its new grayscale value to an unnormalised colour.
+			//
+			// Every formula has a scalar per pixel version and a block version that
+			// works on repaint_lanes pixels at a time in structure of arrays form.
+			// The block loops have a fixed trip count and no branches so that the
+			// compiler vectorises them for the target instruction set.  Block
+			// results match the scalar results to within repaint_tolerance per
+			// channel; only rounding and operation contraction differ
+			constexpr size_t repaint_lanes = 16;
+			constexpr uint32_t repaint_tolerance = 1;
+
+			struct repaint_block {
+				alignas( cache_line_size ) float red[repaint_lanes];
+				alignas( cache_line_size ) float green[repaint_lanes];
+				alignas( cache_line_size ) float blue[repaint_lanes];
+				alignas( cache_line_size ) float gs[repaint_lanes];
+			};
+
+			struct repaint_result {
+				alignas( cache_line_size ) uint32_t red[repaint_lanes];
+				alignas( cache_line_size ) uint32_t green[repaint_lanes];
+				alignas( cache_line_size ) uint32_t blue[repaint_lanes];
+			};
+
+			// The grayscale image is either rgb3 with equal channels or uint8_t
+			constexpr uint8_t gs_value( rgb3 const &grayscale ) noexcept {
+				return grayscale.blue;
+			}
+
+			constexpr uint8_t gs_value( uint8_t const grayscale ) noexcept {
+				return grayscale;
+			}
+
+			// Load count <= repaint_lanes pixels, unused lanes are zero
+			template<typename GS>
+			void load_repaint_block( rgb3 const *orig, GS const *gs,
+			                         size_t const count,
+			                         repaint_block &block ) noexcept {
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					auto const valid = n < count;
+					block.red[n] = valid ? static_cast<float>( orig[n].red ) : 0.0f;
+					block.green[n] = valid ? static_cast<float>( orig[n].green ) : 0.0f;
+					block.blue[n] = valid ? static_cast<float>( orig[n].blue ) : 0.0f;
+					block.gs[n] = valid ? static_cast<float>( gs_value( gs[n] ) ) : 0.0f;
+				}
+			}
+
+			// Float to uint32_t conversions go through int32_t so that negative
+			// values wrap the same way in the scalar and block versions
+			constexpr uint32_t to_channel( float const value ) noexcept {
+				return static_cast<uint32_t>( static_cast<int32_t>( value ) );
+			}
+
+			constexpr float colour_calc( float c, float t1, float t2 ) noexcept {
+				if( c < 0.0f ) {
+					c += 1.0f;
+				} else if( c > 1.0f ) {
+					c -= 1.0f;
+				}
+				if( 6.0f * c < 1.0f ) {
+					return t1 + ( t2 - t1 ) * 6.0f * c;
+				} else if( 2.0f * c < 1.0f ) {
+					return t2;
+				} else if( 3.0f * c < 2.0f ) {
+					return t1 + ( t2 - t1 ) * ( 2.0f / 3.0f - c ) * 6.0f;
+				}
+				return t1;
+			}
+
+			// colour_calc with every branch evaluated and selected
+			inline float colour_calc_select( float c, float const t1,
+			                                 float const t2 ) noexcept {
+				c = c < 0.0f ? c + 1.0f : ( c > 1.0f ? c - 1.0f : c );
+				auto const rising = t1 + ( t2 - t1 ) * 6.0f * c;
+				auto const falling = t1 + ( t2 - t1 ) * ( 2.0f / 3.0f - c ) * 6.0f;
+				return 6.0f * c < 1.0f
+				         ? rising
+				         : ( 2.0f * c < 1.0f ? t2 : ( 3.0f * c < 2.0f ? falling : t1 ) );
+			}
+
+			inline GenericRGB<uint32_t> repaint_ratio( rgb3 const orig,
+			                                           uint8_t const grayscale ) {
+				// Luma = Rx + Gy +Bz
+				// We want Luma -> Luma2
+				// ( Rx + Gy + Bz )/Luma = 1
+				// Luma2*( Rx + Gy + Bz )/Luma = Luma2
+				GenericRGB<float> forig( static_cast<float>( orig.red ),
+				                         static_cast<float>( orig.green ),
+				                         static_cast<float>( orig.blue ) );
+
+				auto const curL = forig.too_float_gs( );
+
+				if( fabs( static_cast<double>( curL ) ) < 0.114 ) {
+					// prevent div by 0 as 0.114 is the minimum value;
+					return GenericRGB<uint32_t>( 0, 0, 0 );
+				}
+				auto const rat = static_cast<float>( grayscale ) / curL;
+				auto red_tmp = daw::math::round<uint32_t>( forig.red * rat );
+				auto green_tmp = daw::math::round<uint32_t>( forig.green * rat );
+				auto blue_tmp = daw::math::round<uint32_t>( forig.blue * rat );
+				return GenericRGB<uint32_t>( red_tmp, green_tmp, blue_tmp );
+			}
+
+			inline void repaint_ratio( repaint_block const &in,
+			                           repaint_result &out ) noexcept {
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					auto const cur_l =
+					  0.299f * in.red[n] + 0.587f * in.green[n] + 0.114f * in.blue[n];
+					auto const valid = cur_l >= 0.114f;
+					auto const rat = in.gs[n] / ( valid ? cur_l : 1.0f );
+					out.red[n] = valid ? to_channel( in.red[n] * rat + 0.5f ) : 0;
+					out.green[n] = valid ? to_channel( in.green[n] * rat + 0.5f ) : 0;
+					out.blue[n] = valid ? to_channel( in.blue[n] * rat + 0.5f ) : 0;
+				}
+			}
+
+			inline GenericRGB<uint32_t> repaint_yuv( rgb3 const orig,
+			                                         uint8_t const grayscale ) {
+				// YUV
+				// Convert back to YUV with Y being the current grayscale value and
+				// then back to RGB uint32_t const retval = 19595*pixel.red +
+				// 38469*pixel.green + 7471*pixel.blue;
+				auto const Y = static_cast<float>( grayscale );
+				auto const U = orig.colform( -0.147f, -0.289f, 0.436f );
+				auto const V = orig.colform( 0.615f, -0.515f, -0.1f );
+
+				auto const R = to_channel( Y + 1.14f * V );
+				auto const G = to_channel( Y - 0.395f * U - 0.581f * V );
+				auto const B = to_channel( Y + 2.032f * U );
+				// int B = (uint32_t)( Y + 1.5f*U );
+				return GenericRGB<uint32_t>( R, G, B );
+			}
+
+			inline void repaint_yuv( repaint_block const &in,
+			                         repaint_result &out ) noexcept {
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					auto const Y = in.gs[n];
+					auto const U =
+					  -0.147f * in.red[n] + -0.289f * in.green[n] + 0.436f * in.blue[n];
+					auto const V =
+					  0.615f * in.red[n] + -0.515f * in.green[n] + -0.1f * in.blue[n];
+					out.red[n] = to_channel( Y + 1.14f * V );
+					out.green[n] = to_channel( Y - 0.395f * U - 0.581f * V );
+					out.blue[n] = to_channel( Y + 2.032f * U );
+				}
+			}
+
+			inline GenericRGB<uint32_t> repaint_multiply_1( rgb3 const orig,
+			                                                uint8_t const grayscale ) {
+				return GenericRGB<uint32_t>( orig.red * grayscale,
+				                             orig.green * grayscale,
+				                             orig.blue * grayscale );
+			}
+
+			inline void repaint_multiply_1( repaint_block const &in,
+			                                repaint_result &out ) noexcept {
+				// Products of 8bit values are exact in a float
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					out.red[n] = to_channel( in.red[n] * in.gs[n] );
+					out.green[n] = to_channel( in.green[n] * in.gs[n] );
+					out.blue[n] = to_channel( in.blue[n] * in.gs[n] );
+				}
+			}
+
+			inline GenericRGB<uint32_t> repaint_addition( rgb3 const orig,
+			                                              uint8_t const grayscale ) {
+				return GenericRGB<uint32_t>( orig.red + grayscale,
+				                             orig.green + grayscale,
+				                             orig.blue + grayscale );
+			}
+
+			inline void repaint_addition( repaint_block const &in,
+			                              repaint_result &out ) noexcept {
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					out.red[n] = to_channel( in.red[n] + in.gs[n] );
+					out.green[n] = to_channel( in.green[n] + in.gs[n] );
+					out.blue[n] = to_channel( in.blue[n] + in.gs[n] );
+				}
+			}
+
+			inline GenericRGB<uint32_t> repaint_multiply_2( rgb3 const orig,
+			                                                uint8_t const grayscale ) {
+				// Mul 2, Mul with individual scaling based on max( R, G, B )
+				auto const maxval = static_cast<float>( orig.max( ) );
+				if( maxval <= 0.0f ) {
+					return GenericRGB<uint32_t>( 0, 0, 0 );
+				}
+				auto const luma = static_cast<float>( grayscale );
+				auto red = to_channel( ( static_cast<float>( orig.red ) * luma ) / maxval );
+				auto green =
+				  to_channel( ( static_cast<float>( orig.green ) * luma ) / maxval );
+				auto blue = to_channel( ( static_cast<float>( orig.blue ) * luma ) / maxval );
+				return GenericRGB<uint32_t>( red, green, blue );
+			}
+
+			inline void repaint_multiply_2( repaint_block const &in,
+			                                repaint_result &out ) noexcept {
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					auto const maxval = std::max( std::max( in.red[n], in.green[n] ), in.blue[n] );
+					auto const valid = maxval > 0.0f;
+					auto const div = valid ? maxval : 1.0f;
+					out.red[n] = valid ? to_channel( ( in.red[n] * in.gs[n] ) / div ) : 0;
+					out.green[n] = valid ? to_channel( ( in.green[n] * in.gs[n] ) / div ) : 0;
+					out.blue[n] = valid ? to_channel( ( in.blue[n] * in.gs[n] ) / div ) : 0;
+				}
+			}
+
+			inline GenericRGB<uint32_t> repaint_hsl( rgb3 const orig,
+			                                         uint8_t const grayscale ) {
+				// HSL
+				auto luma = static_cast<float>( grayscale ) / 255.0f;
+				auto hue = 0.0f;
+				auto saturation = 0.0f;
+				auto const orig_max = orig.max( );
+				auto const orig_min = orig.min( );
+
+				if( 0 == grayscale ) {
+					return GenericRGB<uint32_t>( 0, 0, 0 );
+				} else if( orig_max == orig_min ) {
+					return GenericRGB<uint32_t>( static_cast<uint32_t>( grayscale ) );
+				} else {
+					{
+						auto const orig_maxf = static_cast<float>( orig_max ) / 255.0f;
+						auto const orig_minf = static_cast<float>( orig_min ) / 255.0f;
+						auto const orig_range = orig_maxf - orig_minf;
+						auto L = ( orig_maxf + orig_minf ) / 2.0f;
+						GenericRGB<float> rgb( static_cast<float>( orig.red ) / 255.0f,
+						                       static_cast<float>( orig.green ) / 255.0f,
+						                       static_cast<float>( orig.blue ) / 255.0f );
+
+						if( L < 0.5f ) {
+							saturation = ( orig_range / ( orig_maxf + orig_minf ) );
+						} else {
+							saturation = ( orig_range / ( 2.0f - orig_maxf - orig_minf ) );
+						}
+
+						if( orig_max == orig.red ) {
+							hue = ( rgb.green - rgb.blue ) / orig_range;
+						} else if( orig_max == orig.green ) {
+							hue = 2.0f + ( rgb.blue - rgb.red ) / orig_range;
+						} else {
+							hue = 4.0f + ( rgb.red - rgb.green ) / orig_range;
+						}
+					}
+					GenericRGB<float> rgb( 0.0f );
+					float t1, t2;
+					float th = hue / 6.0f;
+					if( luma < 0.5f ) {
+						t2 = luma * ( 1.0f + saturation );
+					} else {
+						t2 = ( luma + saturation ) - ( luma * saturation );
+					}
+					t1 = 2.0f * luma - t2;
+
+					rgb.red = th + ( 1.0f / 3.0f );
+					rgb.green = th;
+					rgb.blue = th - ( 1.0f / 3.0f );
+
+					rgb.red = colour_calc( rgb.red, t1, t2 );
+					rgb.green = colour_calc( rgb.green, t1, t2 );
+					rgb.blue = colour_calc( rgb.blue, t1, t2 );
+
+					rgb.mul( 255.0f );
+
+					return GenericRGB<uint32_t>( to_channel( rgb.red ),
+					                             to_channel( rgb.green ),
+					                             to_channel( rgb.blue ) );
+				}
+			}
+
+			inline void repaint_hsl( repaint_block const &in,
+			                         repaint_result &out ) noexcept {
+				for( size_t n = 0; n < repaint_lanes; ++n ) {
+					auto const red = in.red[n];
+					auto const green = in.green[n];
+					auto const blue = in.blue[n];
+					auto const orig_max = std::max( std::max( red, green ), blue );
+					auto const orig_min = std::min( std::min( red, green ), blue );
+					auto const is_gray = orig_max == orig_min;
+
+					auto const luma = in.gs[n] / 255.0f;
+					auto const orig_maxf = orig_max / 255.0f;
+					auto const orig_minf = orig_min / 255.0f;
+					// Gray lanes are replaced below, keep their divisors non zero
+					auto const orig_range = is_gray ? 1.0f : orig_maxf - orig_minf;
+					auto const L = ( orig_maxf + orig_minf ) / 2.0f;
+					auto const sat_div = L < 0.5f ? orig_maxf + orig_minf
+					                              : 2.0f - orig_maxf - orig_minf;
+					auto const saturation = orig_range / ( is_gray ? 1.0f : sat_div );
+
+					auto const r = red / 255.0f;
+					auto const g = green / 255.0f;
+					auto const b = blue / 255.0f;
+					auto const hue =
+					  orig_max == red
+					    ? ( g - b ) / orig_range
+					    : ( orig_max == green ? 2.0f + ( b - r ) / orig_range
+					                          : 4.0f + ( r - g ) / orig_range );
+
+					auto const th = hue / 6.0f;
+					auto const t2 = luma < 0.5f ? luma * ( 1.0f + saturation )
+					                            : ( luma + saturation ) - ( luma * saturation );
+					auto const t1 = 2.0f * luma - t2;
+
+					auto const hsl_red =
+					  to_channel( colour_calc_select( th + ( 1.0f / 3.0f ), t1, t2 ) * 255.0f );
+					auto const hsl_green =
+					  to_channel( colour_calc_select( th, t1, t2 ) * 255.0f );
+					auto const hsl_blue =
+					  to_channel( colour_calc_select( th - ( 1.0f / 3.0f ), t1, t2 ) * 255.0f );
+
+					auto const gray = to_channel( in.gs[n] );
+					auto const is_black = in.gs[n] == 0.0f;
+					out.red[n] = is_black ? 0 : ( is_gray ? gray : hsl_red );
+					out.green[n] = is_black ? 0 : ( is_gray ? gray : hsl_green );
+					out.blue[n] = is_black ? 0 : ( is_gray ? gray : hsl_blue );
+				}
+			}
+
+			// The per channel range of repainted pixels.  Colourizing needs the
+			// range of the whole image before any pixel can be normalised, so
+			// partial ranges are collected per chunk and merged
+			struct repaint_range {
+				GenericRGB<uint32_t> minimum{std::numeric_limits<uint32_t>::max( )};
+				GenericRGB<uint32_t> maximum{std::numeric_limits<uint32_t>::min( )};
+
+				void add( repaint_result const &result,
+				          size_t const count ) noexcept {
+					for( size_t n = 0; n < count; ++n ) {
+						GenericRGB<uint32_t> const rgb( result.red[n], result.green[n],
+						                                result.blue[n] );
+						min( rgb, minimum );
+						max( rgb, maximum );
+					}
+				}
+
+				void merge( repaint_range const &other ) noexcept {
+					min( other.minimum, minimum );
+					max( other.maximum, maximum );
+				}
+
+				// A flat repaint has no range, it normalises to black
+				float scale( ) const noexcept {
+					auto const range = maximum.max( ) - minimum.min( );
+					return range == 0 ? 0.0f : 255.0f / static_cast<float>( range );
+				}
+			};
+
+			inline uint8_t normalise_channel( uint32_t const value,
+			                                  uint32_t const minimum,
+			                                  float const scale ) noexcept {
+				auto const result =
+				  static_cast<int32_t>( static_cast<float>( value - minimum ) * scale );
+				return static_cast<uint8_t>( std::min( std::max( result, 0 ), 255 ) );
+			}
+
+			// Normalise count repainted pixels into out
+			inline void normalise_repaint( repaint_result const &result,
+			                               size_t const count,
+			                               repaint_range const &range,
+			                               float const scale, rgb3 *out ) noexcept {
+				for( size_t n = 0; n < count; ++n ) {
+					out[n] = rgb3(
+					  normalise_channel( result.red[n], range.minimum.red, scale ),
+					  normalise_channel( result.green[n], range.minimum.green, scale ),
+					  normalise_channel( result.blue[n], range.minimum.blue, scale ) );
+				}
+			}
+		} // namespace impl
+
+		// The repaint formulas as types, for selecting one at compile time with
+		// FilterDAWGSColourize::filter<Formula>
+		namespace repaint {
+			struct ratio {
+				GenericRGB<uint32_t> operator( )( rgb3 const orig,
+				                                  uint8_t const grayscale ) const {
+					return impl::repaint_ratio( orig, grayscale );
+				}
+
+				void operator( )( impl::repaint_block const &in,
+				                  impl::repaint_result &out ) const noexcept {
+					impl::repaint_ratio( in, out );
+				}
+			};
+
+			struct yuv {
+				GenericRGB<uint32_t> operator( )( rgb3 const orig,
+				                                  uint8_t const grayscale ) const {
+					return impl::repaint_yuv( orig, grayscale );
+				}
+
+				void operator( )( impl::repaint_block const &in,
+				                  impl::repaint_result &out ) const noexcept {
+					impl::repaint_yuv( in, out );
+				}
+			};
+
+			struct multiply_1 {
+				GenericRGB<uint32_t> operator( )( rgb3 const orig,
+				                                  uint8_t const grayscale ) const {
+					return impl::repaint_multiply_1( orig, grayscale );
+				}
+
+				void operator( )( impl::repaint_block const &in,
+				                  impl::repaint_result &out ) const noexcept {
+					impl::repaint_multiply_1( in, out );
+				}
+			};
+
+			struct addition {
+				GenericRGB<uint32_t> operator( )( rgb3 const orig,
+				                                  uint8_t const grayscale ) const {
+					return impl::repaint_addition( orig, grayscale );
+				}
+
+				void operator( )( impl::repaint_block const &in,
+				                  impl::repaint_result &out ) const noexcept {
+					impl::repaint_addition( in, out );
+				}
+			};
+
+			struct multiply_2 {
+				GenericRGB<uint32_t> operator( )( rgb3 const orig,
+				                                  uint8_t const grayscale ) const {
+					return impl::repaint_multiply_2( orig, grayscale );
+				}
+
+				void operator( )( impl::repaint_block const &in,
+				                  impl::repaint_result &out ) const noexcept {
+					impl::repaint_multiply_2( in, out );
+				}
+			};
+
+			struct hsl {
+				GenericRGB<uint32_t> operator( )( rgb3 const orig,
+				                                  uint8_t const grayscale ) const {
+					return impl::repaint_hsl( orig, grayscale );
+				}
+
+				void operator( )( impl::repaint_block const &in,
+				                  impl::repaint_result &out ) const noexcept {
+					impl::repaint_hsl( in, out );
+				}
+			};
+		} // namespace repaint
+	}   // namespace imaging
+} // namespace daw
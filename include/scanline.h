@@ -0,0 +1,101 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <FreeImage.h>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#include "genericrgb.h"
+
+namespace daw {
+	namespace imaging {
+		namespace impl {
+			static_assert( sizeof( rgb3 ) == 3, "rgb3 must be a packed 3 byte pixel" );
+
+			// rgb3 is laid out blue, green, red.  This is FreeImage's 24bpp layout
+			// on little endian machines
+			constexpr bool rgb3_is_freeimage_order =
+			  FI_RGBA_BLUE == 0 && FI_RGBA_GREEN == 1 && FI_RGBA_RED == 2;
+
+			// Convert one 24bpp FreeImage scanline to rgb3
+			inline void scanline24_to_rgb3( uint8_t const *src, rgb3 *dst,
+			                                size_t const width ) noexcept {
+				if( rgb3_is_freeimage_order ) {
+					std::memcpy( dst, src, width * sizeof( rgb3 ) );
+					return;
+				}
+				for( size_t n = 0; n < width; ++n, src += 3 ) {
+					dst[n] = rgb3( src[FI_RGBA_RED], src[FI_RGBA_GREEN],
+					               src[FI_RGBA_BLUE] );
+				}
+			}
+
+			// Convert one 32bpp FreeImage scanline to rgb3, dropping alpha
+			inline void scanline32_to_rgb3( uint8_t const *src, rgb3 *dst,
+			                                size_t const width ) noexcept {
+				size_t n = 0;
+#ifdef __SSSE3__
+				if( rgb3_is_freeimage_order ) {
+					// 4 pixels per shuffle.  Each store writes 16 bytes but only
+					// advances 12, so stop while there is room for the overhang
+					auto const shuffle =
+					  _mm_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+					auto *out = reinterpret_cast<uint8_t *>( dst );
+					for( ; n + 6 <= width; n += 4 ) {
+						auto const px =
+						  _mm_loadu_si128( reinterpret_cast<__m128i const *>( src + 4 * n ) );
+						_mm_storeu_si128( reinterpret_cast<__m128i *>( out + 3 * n ),
+						                  _mm_shuffle_epi8( px, shuffle ) );
+					}
+				}
+#endif
+				for( ; n < width; ++n ) {
+					auto const *px = src + 4 * n;
+					dst[n] =
+					  rgb3( px[FI_RGBA_RED], px[FI_RGBA_GREEN], px[FI_RGBA_BLUE] );
+				}
+			}
+
+			// Convert rgb3 pixels to one 24bpp FreeImage scanline
+			inline void rgb3_to_scanline24( rgb3 const *src, uint8_t *dst,
+			                                size_t const width ) noexcept {
+				if( rgb3_is_freeimage_order ) {
+					std::memcpy( dst, src, width * sizeof( rgb3 ) );
+					return;
+				}
+				for( size_t n = 0; n < width; ++n, dst += 3 ) {
+					dst[FI_RGBA_RED] = src[n].red;
+					dst[FI_RGBA_GREEN] = src[n].green;
+					dst[FI_RGBA_BLUE] = src[n].blue;
+				}
+			}
+		} // namespace impl
+	}   // namespace imaging
+} // namespace daw
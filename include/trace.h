@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Scoped trace spans for the stages of the filters and of image I/O.  Build
+// with DAWFILTER_TRACING defined to record them, otherwise DAW_TRACE_SPAN
+// expands to nothing and the functions below see no events.
+//
+//   DAW_TRACE_SPAN( "FilterDAWGS::mapping" );
+//
+// records the time from there to the end of the enclosing scope.  Names must
+// be string literals, only the pointer is stored
+namespace daw {
+	namespace imaging {
+		namespace trace {
+			struct event {
+				char const *name;
+				// Nanoseconds since the first span of the process
+				uint64_t start_ns;
+				uint64_t duration_ns;
+				// Small sequential id of the recording thread
+				uint32_t thread_id;
+			};
+
+			constexpr bool is_enabled( ) noexcept {
+#ifdef DAWFILTER_TRACING
+				return true;
+#else
+				return false;
+#endif
+			}
+
+			// Every event recorded so far, ordered by start time.  Safe to call
+			// while other threads are recording, their newest spans may be missed
+			std::vector<event> events( );
+
+			// Write events( ) in the Chrome trace event format, for
+			// chrome://tracing or Perfetto
+			void write_chrome_trace( std::ostream &out );
+			void write_chrome_trace( std::string const &filename );
+
+			// Discard all events.  No span may be open on any thread
+			void clear( );
+
+#ifdef DAWFILTER_TRACING
+			namespace impl {
+				uint64_t now_ns( ) noexcept;
+				void record( char const *name, uint64_t start_ns ) noexcept;
+			} // namespace impl
+
+			class span {
+				char const *m_name;
+				uint64_t m_start_ns;
+
+			public:
+				explicit span( char const *name ) noexcept
+				  : m_name( name )
+				  , m_start_ns( impl::now_ns( ) ) {}
+
+				~span( ) {
+					impl::record( m_name, m_start_ns );
+				}
+
+				span( span const & ) = delete;
+				span &operator=( span const & ) = delete;
+			};
+#endif
+		} // namespace trace
+	}   // namespace imaging
+} // namespace daw
+
+#ifdef DAWFILTER_TRACING
+#define DAW_TRACE_CONCAT2( a, b ) a##b
+#define DAW_TRACE_CONCAT( a, b ) DAW_TRACE_CONCAT2( a, b )
+#define DAW_TRACE_SPAN( name )                                                 \
+	::daw::imaging::trace::span DAW_TRACE_CONCAT( daw_trace_span_, __LINE__ )( \
+	  name )
+#else
+#define DAW_TRACE_SPAN( name ) static_cast<void>( 0 )
+#endif
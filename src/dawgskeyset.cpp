@@ -0,0 +1,103 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <daw/daw_exception.h>
+
+#include "dawgskeyset.h"
+#include "parallelchunks.h"
+
+namespace daw {
+	namespace imaging {
+		namespace {
+			inline uint32_t popcount( uint64_t const word ) noexcept {
+				return static_cast<uint32_t>( __builtin_popcountll( word ) );
+			}
+
+			inline uint32_t countr_zero( uint64_t const word ) noexcept {
+				return static_cast<uint32_t>( __builtin_ctzll( word ) );
+			}
+		} // namespace
+
+		DAWGSKeySet::DAWGSKeySet( )
+		  : m_words( word_count, 0 )
+		  , m_ranks{}
+		  , m_size{0} {}
+
+		DAWGSKeySet DAWGSKeySet::merge( std::vector<DAWGSKeySet> partials ) {
+			daw::exception::daw_throw_on_false(
+			  !partials.empty( ), "Cannot merge an empty list of key sets" );
+
+			auto result = std::move( partials.front( ) );
+			if( partials.size( ) > 1 ) {
+				impl::for_each_chunk(
+				  word_count, impl::chunk_count( word_count, 4096 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( auto it = std::next( partials.cbegin( ) );
+					       it != partials.cend( ); ++it ) {
+						  for( size_t n = first; n < last; ++n ) {
+							  result.m_words[n] |= it->m_words[n];
+						  }
+					  }
+				  } );
+			}
+			result.build_ranks( );
+			return result;
+		}
+
+		void DAWGSKeySet::build_ranks( ) {
+			m_ranks.resize( word_count );
+			uint32_t total = 0;
+			for( size_t n = 0; n < word_count; ++n ) {
+				m_ranks[n] = total;
+				total += popcount( m_words[n] );
+			}
+			m_size = total;
+		}
+
+		DAWGSKeySet::key_t DAWGSKeySet::operator[]( size_t const pos ) const {
+			daw::exception::daw_throw_on_false( pos < m_size,
+			                                    "Key index out of range" );
+			// Last word whose rank is <= pos holds the key
+			auto const rank_pos = std::prev( std::upper_bound(
+			  m_ranks.cbegin( ), m_ranks.cend( ), static_cast<uint32_t>( pos ) ) );
+			auto const word_pos =
+			  static_cast<size_t>( std::distance( m_ranks.cbegin( ), rank_pos ) );
+
+			auto word = m_words[word_pos];
+			for( auto n = pos - *rank_pos; n > 0; --n ) {
+				word &= word - 1; // clear lowest set bit
+			}
+			return static_cast<key_t>( word_pos * bits_per_word +
+			                           countr_zero( word ) );
+		}
+
+		DAWGSKeySet::key_t DAWGSKeySet::back( ) const {
+			daw::exception::daw_throw_on_false( m_size > 0,
+			                                    "Empty key set has no back" );
+			return operator[]( m_size - 1 );
+		}
+	} // namespace imaging
+} // namespace daw
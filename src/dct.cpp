@@ -0,0 +1,377 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "dct.h"
+#include "genericimage.h"
+#include "parallelchunks.h"
+
+namespace daw {
+	namespace imaging {
+		namespace dct {
+			namespace {
+				// Scale of each AAN output relative to the orthonormal DCT,
+				// aan_scale[0] = 1, aan_scale[k] = sqrt( 2 ) * cos( k * pi / 16 )
+				constexpr std::array<double, block_width> aan_scale = {
+				  1.0,         1.387039845, 1.306562965, 1.175875602,
+				  1.0,         0.785694958, 0.541196100, 0.275899379};
+
+				template<typename Func>
+				constexpr std::array<double, block_size> make_scale_table( Func func ) {
+					std::array<double, block_size> result{};
+					for( size_t v = 0; v < block_width; ++v ) {
+						for( size_t u = 0; u < block_width; ++u ) {
+							result[v * block_width + u] = func( aan_scale[v] * aan_scale[u] );
+						}
+					}
+					return result;
+				}
+
+				// Integer transforms carry int_pass_bits extra bits of precision
+				// between passes
+				constexpr int32_t int_const_bits = 13;
+				constexpr int32_t int_pass_bits = 3;
+				constexpr int32_t int_forward_bits = 24;
+				constexpr int32_t int_inverse_bits = 16;
+
+				constexpr auto float_forward_scale =
+				  make_scale_table( []( double s ) { return 1.0 / ( 8.0 * s ); } );
+
+				constexpr auto float_inverse_scale =
+				  make_scale_table( []( double s ) { return s / 8.0; } );
+
+				template<typename Func>
+				constexpr std::array<int64_t, block_size> make_fixed_table( Func func ) {
+					auto const table = make_scale_table( func );
+					std::array<int64_t, block_size> result{};
+					for( size_t n = 0; n < block_size; ++n ) {
+						result[n] = static_cast<int64_t>( table[n] + 0.5 );
+					}
+					return result;
+				}
+
+				constexpr auto int_forward_scale = make_fixed_table( []( double s ) {
+					return static_cast<double>( 1 << int_forward_bits ) /
+					       static_cast<double>( 1 << ( 2 * int_pass_bits ) ) / s;
+				} );
+
+				constexpr auto int_inverse_scale = make_fixed_table( []( double s ) {
+					return s *
+					       static_cast<double>( 1 << ( int_inverse_bits + int_pass_bits ) );
+				} );
+
+				template<typename T>
+				struct arithmetic;
+
+				template<>
+				struct arithmetic<float> {
+					static constexpr float constant( double const c ) noexcept {
+						return static_cast<float>( c );
+					}
+
+					static constexpr float mul( float const x, float const c ) noexcept {
+						return x * c;
+					}
+				};
+
+				template<>
+				struct arithmetic<int32_t> {
+					static constexpr int32_t constant( double const c ) noexcept {
+						return static_cast<int32_t>( c * ( 1 << int_const_bits ) + 0.5 );
+					}
+
+					static constexpr int32_t mul( int32_t const x,
+					                              int32_t const c ) noexcept {
+						return static_cast<int32_t>(
+						  ( static_cast<int64_t>( x ) * c + ( 1 << ( int_const_bits - 1 ) ) ) >>
+						  int_const_bits );
+					}
+				};
+
+				// One dimensional AAN forward transform of 8 values stride apart.
+				// The outputs are the orthonormal DCT scaled by sqrt( 8 ) *
+				// aan_scale[k], so after both passes coefficient ( v, u ) is scaled
+				// by 8 * aan_scale[v] * aan_scale[u]
+				template<typename T>
+				void forward_1d( T *data, size_t const stride ) noexcept {
+					using math = arithmetic<T>;
+					constexpr auto c0_707 = math::constant( 0.707106781 );
+					constexpr auto c0_382 = math::constant( 0.382683433 );
+					constexpr auto c0_541 = math::constant( 0.541196100 );
+					constexpr auto c1_306 = math::constant( 1.306562965 );
+
+					auto const tmp0 = data[0] + data[7 * stride];
+					auto const tmp7 = data[0] - data[7 * stride];
+					auto const tmp1 = data[stride] + data[6 * stride];
+					auto const tmp6 = data[stride] - data[6 * stride];
+					auto const tmp2 = data[2 * stride] + data[5 * stride];
+					auto const tmp5 = data[2 * stride] - data[5 * stride];
+					auto const tmp3 = data[3 * stride] + data[4 * stride];
+					auto const tmp4 = data[3 * stride] - data[4 * stride];
+
+					// Even part
+					auto tmp10 = tmp0 + tmp3;
+					auto const tmp13 = tmp0 - tmp3;
+					auto tmp11 = tmp1 + tmp2;
+					auto tmp12 = tmp1 - tmp2;
+
+					data[0] = tmp10 + tmp11;
+					data[4 * stride] = tmp10 - tmp11;
+
+					auto const z1 = math::mul( tmp12 + tmp13, c0_707 );
+					data[2 * stride] = tmp13 + z1;
+					data[6 * stride] = tmp13 - z1;
+
+					// Odd part
+					tmp10 = tmp4 + tmp5;
+					tmp11 = tmp5 + tmp6;
+					tmp12 = tmp6 + tmp7;
+
+					auto const z5 = math::mul( tmp10 - tmp12, c0_382 );
+					auto const z2 = math::mul( tmp10, c0_541 ) + z5;
+					auto const z4 = math::mul( tmp12, c1_306 ) + z5;
+					auto const z3 = math::mul( tmp11, c0_707 );
+
+					auto const z11 = tmp7 + z3;
+					auto const z13 = tmp7 - z3;
+
+					data[5 * stride] = z13 + z2;
+					data[3 * stride] = z13 - z2;
+					data[stride] = z11 + z4;
+					data[7 * stride] = z11 - z4;
+				}
+
+				// One dimensional AAN inverse transform of 8 values stride apart.
+				// The inputs must be scaled by aan_scale[k] and the outputs are
+				// sqrt( 8 ) times the samples, so 8 times after both passes
+				template<typename T>
+				void inverse_1d( T *data, size_t const stride ) noexcept {
+					using math = arithmetic<T>;
+					constexpr auto c1_414 = math::constant( 1.414213562 );
+					constexpr auto c1_847 = math::constant( 1.847759065 );
+					constexpr auto c1_082 = math::constant( 1.082392200 );
+					constexpr auto c2_613 = math::constant( 2.613125930 );
+
+					// Even part
+					auto tmp0 = data[0];
+					auto tmp1 = data[2 * stride];
+					auto tmp2 = data[4 * stride];
+					auto tmp3 = data[6 * stride];
+
+					auto tmp10 = tmp0 + tmp2;
+					auto tmp11 = tmp0 - tmp2;
+					auto const tmp13 = tmp1 + tmp3;
+					auto tmp12 = math::mul( tmp1 - tmp3, c1_414 ) - tmp13;
+
+					tmp0 = tmp10 + tmp13;
+					tmp3 = tmp10 - tmp13;
+					tmp1 = tmp11 + tmp12;
+					tmp2 = tmp11 - tmp12;
+
+					// Odd part
+					auto const z13 = data[5 * stride] + data[3 * stride];
+					auto const z10 = data[5 * stride] - data[3 * stride];
+					auto const z11 = data[stride] + data[7 * stride];
+					auto const z12 = data[stride] - data[7 * stride];
+
+					auto const tmp7 = z11 + z13;
+					tmp11 = math::mul( z11 - z13, c1_414 );
+
+					auto const z5 = math::mul( z10 + z12, c1_847 );
+					tmp10 = math::mul( z12, c1_082 ) - z5;
+					tmp12 = z5 - math::mul( z10, c2_613 );
+
+					auto const tmp6 = tmp12 - tmp7;
+					auto const tmp5 = tmp11 - tmp6;
+					auto const tmp4 = tmp10 + tmp5;
+
+					data[0] = tmp0 + tmp7;
+					data[7 * stride] = tmp0 - tmp7;
+					data[stride] = tmp1 + tmp6;
+					data[6 * stride] = tmp1 - tmp6;
+					data[2 * stride] = tmp2 + tmp5;
+					data[5 * stride] = tmp2 - tmp5;
+					data[4 * stride] = tmp3 + tmp4;
+					data[3 * stride] = tmp3 - tmp4;
+				}
+
+				template<typename T>
+				void forward_2d( T *data ) noexcept {
+					for( size_t row = 0; row < block_width; ++row ) {
+						forward_1d( data + row * block_width, 1 );
+					}
+					for( size_t col = 0; col < block_width; ++col ) {
+						forward_1d( data + col, block_width );
+					}
+				}
+
+				template<typename T>
+				void inverse_2d( T *data ) noexcept {
+					for( size_t col = 0; col < block_width; ++col ) {
+						inverse_1d( data + col, block_width );
+					}
+					for( size_t row = 0; row < block_width; ++row ) {
+						inverse_1d( data + row * block_width, 1 );
+					}
+				}
+
+				// Fixed point multiply by a scale table entry with shift fractional
+				// bits, rounding to nearest
+				inline int32_t scale( int32_t const value, int64_t const fixed,
+				                      int32_t const shift ) noexcept {
+					return static_cast<int32_t>(
+					  ( static_cast<int64_t>( value ) * fixed +
+					    ( static_cast<int64_t>( 1 ) << ( shift - 1 ) ) ) >>
+					  shift );
+				}
+
+				uint8_t to_sample( float const value ) noexcept {
+					auto const level = static_cast<int32_t>( std::floor( value + 0.5f ) );
+					return static_cast<uint8_t>( std::min( std::max( level, 0 ), 255 ) );
+				}
+
+				uint8_t to_sample( int32_t const value ) noexcept {
+					return static_cast<uint8_t>( std::min( std::max( value, 0 ), 255 ) );
+				}
+			} // namespace
+
+			void forward( float_block &block ) noexcept {
+				forward_2d( block.data( ) );
+				for( size_t n = 0; n < block_size; ++n ) {
+					block[n] *= static_cast<float>( float_forward_scale[n] );
+				}
+			}
+
+			void inverse( float_block &block ) noexcept {
+				for( size_t n = 0; n < block_size; ++n ) {
+					block[n] *= static_cast<float>( float_inverse_scale[n] );
+				}
+				inverse_2d( block.data( ) );
+			}
+
+			void forward( int_block &block ) noexcept {
+				for( auto &value : block ) {
+					value *= ( 1 << int_pass_bits );
+				}
+				forward_2d( block.data( ) );
+				for( size_t n = 0; n < block_size; ++n ) {
+					block[n] = scale( block[n], int_forward_scale[n], int_forward_bits );
+				}
+			}
+
+			void inverse( int_block &block ) noexcept {
+				for( size_t n = 0; n < block_size; ++n ) {
+					block[n] = scale( block[n], int_inverse_scale[n], int_inverse_bits );
+				}
+				inverse_2d( block.data( ) );
+				for( auto &value : block ) {
+					value =
+					  ( value + ( 1 << ( 2 + int_pass_bits ) ) ) >> ( 3 + int_pass_bits );
+				}
+			}
+
+			template<typename Block>
+			std::vector<Block> forward_blocks( GenericImage<uint8_t> const &image ) {
+				using value_t = typename Block::value_type;
+				auto const width = image.width( );
+				auto const height = image.height( );
+				auto const blocks_wide = ( width + block_width - 1 ) / block_width;
+				auto const blocks_high = ( height + block_width - 1 ) / block_width;
+
+				std::vector<Block> result( block_count( width, height ) );
+				impl::for_each_chunk(
+				  blocks_high, impl::chunk_count( blocks_high, 4 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t by = first; by < last; ++by ) {
+						  for( size_t bx = 0; bx < blocks_wide; ++bx ) {
+							  auto &block = result[by * blocks_wide + bx];
+							  for( size_t y = 0; y < block_width; ++y ) {
+								  auto const *const row =
+								    image.row( std::min( by * block_width + y, height - 1 ) );
+								  for( size_t x = 0; x < block_width; ++x ) {
+									  block[y * block_width + x] = static_cast<value_t>(
+									    row[std::min( bx * block_width + x, width - 1 )] );
+								  }
+							  }
+							  forward( block );
+						  }
+					  }
+				  } );
+				return result;
+			}
+
+			template<typename Block>
+			GenericImage<uint8_t> inverse_blocks( std::vector<Block> const &blocks,
+			                                      size_t const width,
+			                                      size_t const height ) {
+				daw::exception::daw_throw_on_false(
+				  blocks.size( ) == block_count( width, height ),
+				  "Block count does not match the image size" );
+				auto const blocks_wide = ( width + block_width - 1 ) / block_width;
+				auto const blocks_high = ( height + block_width - 1 ) / block_width;
+
+				GenericImage<uint8_t> result( width, height, no_init );
+				impl::for_each_chunk(
+				  blocks_high, impl::chunk_count( blocks_high, 4 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t by = first; by < last; ++by ) {
+						  for( size_t bx = 0; bx < blocks_wide; ++bx ) {
+							  auto block = blocks[by * blocks_wide + bx];
+							  inverse( block );
+							  auto const rows =
+							    std::min( block_width, height - by * block_width );
+							  auto const cols =
+							    std::min( block_width, width - bx * block_width );
+							  for( size_t y = 0; y < rows; ++y ) {
+								  auto *const row = result.row( by * block_width + y );
+								  for( size_t x = 0; x < cols; ++x ) {
+									  row[bx * block_width + x] =
+									    to_sample( block[y * block_width + x] );
+								  }
+							  }
+						  }
+					  }
+				  } );
+				return result;
+			}
+
+			template std::vector<float_block>
+			forward_blocks<float_block>( GenericImage<uint8_t> const & );
+			template std::vector<int_block>
+			forward_blocks<int_block>( GenericImage<uint8_t> const & );
+
+			template GenericImage<uint8_t>
+			inverse_blocks<float_block>( std::vector<float_block> const &,
+			                             size_t const, size_t const );
+			template GenericImage<uint8_t>
+			inverse_blocks<int_block>( std::vector<int_block> const &, size_t const,
+			                           size_t const );
+		} // namespace dct
+	}   // namespace imaging
+} // namespace daw
@@ -0,0 +1,88 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <utility>
+
+#include <daw/daw_exception.h>
+
+#include "executor.h"
+
+namespace daw {
+	namespace imaging {
+		TaskPool::TaskPool( size_t const thread_count )
+		  : m_mutex{}
+		  , m_has_task{}
+		  , m_tasks{}
+		  , m_threads{}
+		  , m_closed{false} {
+			auto const count = std::max( thread_count, static_cast<size_t>( 1 ) );
+			m_threads.reserve( count );
+			for( size_t n = 0; n < count; ++n ) {
+				m_threads.emplace_back( [this]( ) { run_tasks( ); } );
+			}
+		}
+
+		TaskPool::~TaskPool( ) {
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_closed = true;
+			}
+			m_has_task.notify_all( );
+			for( auto &thread : m_threads ) {
+				thread.join( );
+			}
+		}
+
+		void TaskPool::run_tasks( ) {
+			while( true ) {
+				std::function<void( )> task{};
+				{
+					std::unique_lock<std::mutex> lock( m_mutex );
+					m_has_task.wait(
+					  lock, [this]( ) { return m_closed || !m_tasks.empty( ); } );
+					if( m_tasks.empty( ) ) {
+						return;
+					}
+					task = std::move( m_tasks.front( ) );
+					m_tasks.pop_front( );
+				}
+				task( );
+			}
+		}
+
+		void TaskPool::add_task( std::function<void( )> task ) {
+			daw::exception::daw_throw_on_false( static_cast<bool>( task ),
+			                                    "TaskPool task is empty" );
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				m_tasks.push_back( std::move( task ) );
+			}
+			m_has_task.notify_one( );
+		}
+
+		TaskPool &default_task_pool( ) {
+			static TaskPool s_pool{};
+			return s_pool;
+		}
+	} // namespace imaging
+} // namespace daw
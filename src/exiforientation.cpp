@@ -0,0 +1,161 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+
+#include <daw/daw_exception.h>
+
+#include "exiforientation.h"
+
+namespace daw {
+	namespace imaging {
+		namespace exif {
+			namespace {
+				constexpr uint8_t marker_prefix = 0xFF;
+				constexpr uint8_t marker_soi = 0xD8;
+				constexpr uint8_t marker_eoi = 0xD9;
+				constexpr uint8_t marker_sos = 0xDA;
+				constexpr uint8_t marker_app1 = 0xE1;
+				constexpr uint16_t orientation_tag_id = 0x0112;
+				constexpr uint16_t tiff_short = 3;
+				constexpr size_t ifd_entry_size = 12;
+
+				constexpr bool is_standalone( uint8_t const marker ) noexcept {
+					return marker == 0x01 || ( marker >= 0xD0 && marker <= 0xD7 );
+				}
+
+				uint16_t read_u16( uint8_t const *p, bool const big_endian ) noexcept {
+					return big_endian ? static_cast<uint16_t>( ( p[0] << 8 ) | p[1] )
+					                  : static_cast<uint16_t>( ( p[1] << 8 ) | p[0] );
+				}
+
+				uint32_t read_u32( uint8_t const *p, bool const big_endian ) noexcept {
+					return big_endian
+					         ? ( static_cast<uint32_t>( read_u16( p, true ) ) << 16U ) |
+					             read_u16( p + 2, true )
+					         : ( static_cast<uint32_t>( read_u16( p + 2, false ) )
+					             << 16U ) |
+					             read_u16( p, false );
+				}
+
+				// Search IFD0 of the TIFF structure in [tiff, tiff + size)
+				std::optional<orientation_tag> find_in_tiff( uint8_t const *tiff,
+				                                             size_t const size ) {
+					if( size < 8 ) {
+						return std::nullopt;
+					}
+					bool big_endian = false;
+					if( tiff[0] == 'M' && tiff[1] == 'M' ) {
+						big_endian = true;
+					} else if( !( tiff[0] == 'I' && tiff[1] == 'I' ) ) {
+						return std::nullopt;
+					}
+					if( read_u16( tiff + 2, big_endian ) != 42 ) {
+						return std::nullopt;
+					}
+					size_t const ifd = read_u32( tiff + 4, big_endian );
+					if( ifd > size - 2 ) {
+						return std::nullopt;
+					}
+					size_t const entries = read_u16( tiff + ifd, big_endian );
+					if( entries > ( size - ifd - 2 ) / ifd_entry_size ) {
+						return std::nullopt;
+					}
+					for( size_t n = 0; n < entries; ++n ) {
+						auto const *entry = tiff + ifd + 2 + n * ifd_entry_size;
+						if( read_u16( entry, big_endian ) == orientation_tag_id &&
+						    read_u16( entry + 2, big_endian ) == tiff_short &&
+						    read_u32( entry + 4, big_endian ) == 1 ) {
+							return orientation_tag{
+							  static_cast<size_t>( entry + 8 - tiff ), big_endian};
+						}
+					}
+					return std::nullopt;
+				}
+			} // namespace
+
+			std::optional<orientation_tag>
+			find_orientation_tag( std::vector<uint8_t> const &jpeg ) {
+				auto const size = jpeg.size( );
+				if( size < 4 || jpeg[0] != marker_prefix || jpeg[1] != marker_soi ) {
+					return std::nullopt;
+				}
+				size_t pos = 2;
+				while( pos + 4 <= size ) {
+					if( jpeg[pos] != marker_prefix ) {
+						return std::nullopt;
+					}
+					auto const marker = jpeg[pos + 1];
+					if( marker == marker_prefix ) {
+						// Fill byte
+						++pos;
+						continue;
+					}
+					if( is_standalone( marker ) ) {
+						pos += 2;
+						continue;
+					}
+					if( marker == marker_sos || marker == marker_eoi ) {
+						// Metadata segments all come before the scan data
+						return std::nullopt;
+					}
+					size_t const length = read_u16( jpeg.data( ) + pos + 2, true );
+					if( length < 2 || pos + 2 + length > size ) {
+						return std::nullopt;
+					}
+					auto const *const segment = jpeg.data( ) + pos + 4;
+					auto const segment_size = length - 2;
+					if( marker == marker_app1 && segment_size > 6 &&
+					    std::memcmp( segment, "Exif\0\0", 6 ) == 0 ) {
+						auto result = find_in_tiff( segment + 6, segment_size - 6 );
+						if( result ) {
+							result->offset += pos + 4 + 6;
+						}
+						return result;
+					}
+					pos += 2 + length;
+				}
+				return std::nullopt;
+			}
+
+			orientation read_orientation( std::vector<uint8_t> const &jpeg,
+			                              orientation_tag const &tag ) {
+				daw::exception::daw_throw_on_false( tag.offset + 2 <= jpeg.size( ),
+				                                    "Invalid EXIF orientation tag" );
+				return from_tag_value(
+				  read_u16( jpeg.data( ) + tag.offset, tag.big_endian ) );
+			}
+
+			void write_orientation( std::vector<uint8_t> &jpeg,
+			                        orientation_tag const &tag,
+			                        orientation const o ) {
+				daw::exception::daw_throw_on_false( tag.offset + 2 <= jpeg.size( ),
+				                                    "Invalid EXIF orientation tag" );
+				auto const value = to_tag_value( o );
+				auto const high = static_cast<uint8_t>( value >> 8U );
+				auto const low = static_cast<uint8_t>( value & 0xFFU );
+				jpeg[tag.offset] = tag.big_endian ? high : low;
+				jpeg[tag.offset + 1] = tag.big_endian ? low : high;
+			}
+		} // namespace exif
+	}   // namespace imaging
+} // namespace daw
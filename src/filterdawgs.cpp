@@ -20,7 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include <iostream>
+#include <algorithm>
 #include <iterator>
 #include <map>
 #include <unordered_map>
@@ -30,80 +30,453 @@
 #include <daw/daw_algorithm.h>
 #include <daw/daw_array.h>
 #include <daw/daw_container_algorithm.h>
+#include <daw/daw_exception.h>
 #include <daw/fs/algorithms.h>
 
+#include "dawgsbinmap.h"
+#include "dawgskeyset.h"
 #include "filterdawgs.h"
 #include "genericimage.h"
 #include "genericrgb.h"
+#include "imagebuffer.h"
+#include "netpbm.h"
+#include "parallelchunks.h"
+#include "trace.h"
 
 namespace daw {
 	namespace imaging {
 		namespace impl {
-			GenericImage<rgb3> to_small_gs( GenericImage<rgb3> const &input_image ) {
-				GenericImage<rgb3> image_output{input_image.width( ),
-				                                input_image.height( )};
+			constexpr uint8_t small_gs( rgb3 const &rgb ) noexcept {
+				return static_cast<uint8_t>( rgb.too_float_gs( ) );
+			}
+		} // namespace impl
 
-				std::transform( input_image.cbegin( ), input_image.cend( ),
-				                image_output.begin( ), []( rgb3 const &rgb ) {
-					                return static_cast<uint8_t>( rgb.too_float_gs( ) );
-				                } );
+		namespace {
+			// Call map_pixels( row_first, row_last, out_row( y ) ) for every row,
+			// with the rows split across threads
+			template<typename MapPixels, typename OutRow>
+			void map_rows( ImageView<rgb3> const &input_image, MapPixels map_pixels,
+			               OutRow out_row ) {
+				impl::for_each_chunk(
+				  input_image.height( ), impl::chunk_count( input_image.height( ), 16 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t y = first; y < last; ++y ) {
+						  auto const *row = input_image.row( y );
+						  map_pixels( row, row + input_image.width( ), out_row( y ) );
+					  }
+				  } );
+			}
 
-				return image_output;
+			// As above, for rows read through a rotation or reflection.  Each thread
+			// gathers its rows a band at a time so no rotated copy of the whole
+			// image is made
+			template<typename MapPixels, typename OutRow>
+			void map_rows( OrientedView<rgb3> const &input_image,
+			               MapPixels map_pixels, OutRow out_row ) {
+				if( input_image.is_identity( ) ) {
+					map_rows( input_image.source( ), map_pixels, out_row );
+					return;
+				}
+				auto const width = input_image.width( );
+				auto const band_rows = OrientedView<rgb3>::band_rows;
+				impl::for_each_chunk(
+				  input_image.height( ),
+				  impl::chunk_count( input_image.height( ), band_rows ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  image_vector<rgb3> band( band_rows * width );
+					  for( size_t y0 = first; y0 < last; y0 += band_rows ) {
+						  auto const row_count = std::min( band_rows, last - y0 );
+						  input_image.copy_rows( y0, row_count, band.data( ) );
+						  for( size_t r = 0; r < row_count; ++r ) {
+							  auto const *row = band.data( ) + r * width;
+							  map_pixels( row, row + width, out_row( y0 + r ) );
+						  }
+					  }
+				  } );
 			}
-		}
-		GenericImage<rgb3>
-		FilterDAWGS::filter( GenericImage<rgb3> const &input_image ) {
 
-			std::vector<uint32_t> const keys = [&]( ) {
-				std::vector<uint32_t> v{};
-				v.resize( input_image.size( ) );
+			// The distinct keys do not depend on the orientation, so they are
+			// collected from the source rows in place
+			ImageView<rgb3> const &key_source( ImageView<rgb3> const &input_image ) {
+				return input_image;
+			}
+
+			ImageView<rgb3> const &
+			key_source( OrientedView<rgb3> const &input_image ) {
+				return input_image.source( );
+			}
+
+			void map_small_gs( rgb3 const *first, rgb3 const *const last,
+			                   rgb3 *out ) {
+				std::transform( first, last, out, impl::small_gs );
+			}
+
+			void map_small_gs( rgb3 const *first, rgb3 const *const last,
+			                   uint8_t *out ) {
+				std::transform( first, last, out, impl::small_gs );
+			}
+
+			// Sort runs of v in parallel, then merge neighbouring runs in rounds
+			// until one is left.  The runs come from impl::chunk_count, so the
+			// sort uses no more threads than set_thread_limit allows
+			void sort_keys( image_vector<uint32_t> &v ) {
+				auto const runs = impl::chunk_count( v.size( ), 1U << 16U );
+				impl::for_each_chunk(
+				  v.size( ), runs,
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  std::sort( v.begin( ) + static_cast<ptrdiff_t>( first ),
+					             v.begin( ) + static_cast<ptrdiff_t>( last ) );
+				  } );
+				if( runs <= 1 ) {
+					return;
+				}
+				// Same boundaries as for_each_chunk
+				auto const bound = [&]( size_t const run ) {
+					return static_cast<ptrdiff_t>( ( v.size( ) * run ) / runs );
+				};
+				image_vector<uint32_t> merged( v.size( ) );
+				for( size_t width = 1; width < runs; width *= 2 ) {
+					auto const merges = ( runs + 2 * width - 1 ) / ( 2 * width );
+					impl::for_each_chunk(
+					  merges, merges,
+					  [&]( size_t, size_t const first, size_t const last ) {
+						  for( size_t m = first; m < last; ++m ) {
+							  auto const lo = 2 * width * m;
+							  auto const mid = std::min( lo + width, runs );
+							  auto const hi = std::min( lo + 2 * width, runs );
+							  std::merge( v.begin( ) + bound( lo ), v.begin( ) + bound( mid ),
+							              v.begin( ) + bound( mid ), v.begin( ) + bound( hi ),
+							              merged.begin( ) + bound( lo ) );
+						  }
+					  } );
+					v.swap( merged );
+				}
+			}
 
-				daw::algorithm::parallel::transform(
-				  input_image.begin( ), input_image.end( ), v.begin( ),
-				  []( auto rgb ) { return daw::imaging::FilterDAWGS::too_gs( rgb ); } );
+			image_vector<uint32_t>
+			sort_unique_keys( ImageView<rgb3> const &input_image ) {
+				image_vector<uint32_t> v{};
+				v.resize( input_image.size( ) );
 
-				daw::algorithm::parallel::sort( v.begin( ), v.end( ) );
+				{
+					DAW_TRACE_SPAN( "FilterDAWGS::key_extraction" );
+					map_rows(
+					  input_image,
+					  []( rgb3 const *first, rgb3 const *const last, uint32_t *out ) {
+						  std::transform( first, last, out, []( rgb3 const &rgb ) {
+							  return FilterDAWGS::too_gs( rgb );
+						  } );
+					  },
+					  [&]( size_t const y ) {
+						  return v.data( ) + y * input_image.width( );
+					  } );
+				}
+				{
+					DAW_TRACE_SPAN( "FilterDAWGS::sort" );
+					sort_keys( v );
+				}
+				DAW_TRACE_SPAN( "FilterDAWGS::unique" );
 				v.erase( std::unique( v.begin( ), v.end( ) ), v.end( ) );
 				return v;
-			}( );
-			// If we must compress as there isn't room for number of grayscale items
-			if( keys.size( ) <= 256 ) {
-				std::cerr << "Already a grayscale image or has enough room for all "
-										 "possible values and no compression needed:"
-									<< keys.size( ) << std::endl;
-				return impl::to_small_gs( input_image );
 			}
 
-			std::array<uint32_t, 256> bins = [&keys]( ) {
-				std::array<uint32_t, 256> a{};
-				auto const inc = static_cast<float>( keys.size( ) ) / 256.0f;
-				for( size_t n=0; n<255; ++n ) {
-					a[n] = keys[static_cast<size_t>(static_cast<float>(n)*inc)];
+			// Each chunk zeroes a ~2MB bitset, keep chunks large enough to pay for
+			// it
+			std::vector<DAWGSKeySet> make_partial_keys( size_t const pixel_count ) {
+				return std::vector<DAWGSKeySet>(
+				  impl::chunk_count( pixel_count, 1U << 20U ) );
+			}
+
+			void insert_keys( std::vector<DAWGSKeySet> &partials,
+			                  ImageView<rgb3> const &input_image ) {
+				DAW_TRACE_SPAN( "FilterDAWGS::key_extraction" );
+				impl::for_each_chunk(
+				  input_image.height( ), partials.size( ),
+				  [&]( size_t const chunk, size_t const first, size_t const last ) {
+					  auto &keys = partials[chunk];
+					  for( size_t y = first; y < last; ++y ) {
+						  auto const *row = input_image.row( y );
+						  for( size_t x = 0; x < input_image.width( ); ++x ) {
+							  keys.insert( FilterDAWGS::too_gs( row[x] ) );
+						  }
+					  }
+				  } );
+			}
+
+			DAWGSKeySet merge_keys( std::vector<DAWGSKeySet> partials ) {
+				DAW_TRACE_SPAN( "FilterDAWGS::key_merge" );
+				return DAWGSKeySet::merge( std::move( partials ) );
+			}
+
+			template<typename Keys>
+			DAWGSBinMap build_bin_map( Keys const &keys ) {
+				DAW_TRACE_SPAN( "FilterDAWGS::bin_building" );
+				return DAWGSBinMap::from_keys( keys );
+			}
+
+			DAWGSKeySet bitset_keys( ImageView<rgb3> const &input_image ) {
+				auto partials = make_partial_keys( input_image.size( ) );
+				insert_keys( partials, input_image );
+				return merge_keys( std::move( partials ) );
+			}
+
+			// Keys is a sorted, distinct, random access range of too_gs values.  Out
+			// is rgb3 or uint8_t.  Source is an ImageView or OrientedView of rgb3
+			template<typename Out, typename Keys, typename Source>
+			GenericImage<Out> dawgs( Source const &input_image, Keys const &keys ) {
+				GenericImage<Out> output_image{input_image.width( ),
+				                               input_image.height( ), no_init};
+				auto const out_row = [&]( size_t const y ) {
+					return output_image.row( y );
+				};
+
+				// If we must compress as there isn't room for number of grayscale
+				// items
+				if( keys.size( ) <= 256 ) {
+					DAW_TRACE_SPAN( "FilterDAWGS::mapping" );
+					map_rows( input_image,
+					          []( rgb3 const *first, rgb3 const *const last, Out *out ) {
+						          map_small_gs( first, last, out );
+					          },
+					          out_row );
+					return output_image;
+				}
+
+				auto const bin_map = build_bin_map( keys );
+				DAW_TRACE_SPAN( "FilterDAWGS::mapping" );
+				map_rows( input_image,
+				          [&bin_map]( rgb3 const *first, rgb3 const *const last,
+				                      Out *out ) {
+					          bin_map.map( first, last, out, []( rgb3 const &rgb ) {
+						          return FilterDAWGS::too_gs( rgb );
+					          } );
+				          },
+				          out_row );
+				return output_image;
+			}
+		} // namespace
+
+		namespace {
+			// Calls func( keys, count, pos ) for blocks of the keys of pixels
+			// [first, last) of a planar image.  pos is the index of the first key
+			template<typename Func>
+			void for_each_key_block( PlanarImage<uint8_t> const &input_image,
+			                         size_t first, size_t const last, Func func ) {
+				std::array<uint32_t, DAWGSBinMap::block_size> keys;
+				auto const *const red = input_image.red( );
+				auto const *const green = input_image.green( );
+				auto const *const blue = input_image.blue( );
+				while( first < last ) {
+					auto const count = std::min( last - first, keys.size( ) );
+					for( size_t n = 0; n < count; ++n ) {
+						keys[n] = FilterDAWGS::too_gs( red[first + n], green[first + n],
+						                               blue[first + n] );
+					}
+					func( keys.data( ), count, first );
+					first += count;
+				}
+			}
+
+			DAWGSKeySet bitset_keys( PlanarImage<uint8_t> const &input_image ) {
+				auto partials = make_partial_keys( input_image.size( ) );
+				{
+					DAW_TRACE_SPAN( "FilterDAWGS::key_extraction" );
+					impl::for_each_chunk(
+					  input_image.size( ), partials.size( ),
+					  [&]( size_t const chunk, size_t const first, size_t const last ) {
+						  auto &keys = partials[chunk];
+						  for_each_key_block(
+						    input_image, first, last,
+						    [&keys]( uint32_t const *block, size_t const count, size_t ) {
+							    for( size_t n = 0; n < count; ++n ) {
+								    keys.insert( block[n] );
+							    }
+						    } );
+					  } );
 				}
-				a[255] = keys.back( );
-				return a;
-			}( );
-			GenericImage<rgb3> output_image{input_image.width( ),
-			                                input_image.height( )};
-
-			daw::algorithm::parallel::transform(
-			  input_image.cbegin( ), input_image.cend( ), output_image.begin( ),
-			  [&bins]( auto rgb ) -> uint8_t {
-			  	auto const val = FilterDAWGS::too_gs( rgb );
-			  	for( uint8_t n=0; n<static_cast<uint8_t>( bins.size( ) ); ++n ) {
-			  		if( bins[n] >= val ) {
-			  			return n;
-			  		}
-			  	}
-			  	std::abort( );
+				return merge_keys( std::move( partials ) );
+			}
+
+			template<typename Out, typename Source>
+			GenericImage<Out> dawgs( Source const &input_image,
+			                         FilterDAWGS::key_engines const key_engine ) {
+				auto const &keys_from = key_source( input_image );
+				switch( key_engine ) {
+				case FilterDAWGS::key_engines::sort_unique:
+					return dawgs<Out>( input_image, sort_unique_keys( keys_from ) );
+				case FilterDAWGS::key_engines::bitset:
+					return dawgs<Out>( input_image, bitset_keys( keys_from ) );
+				}
+				throw std::runtime_error( "Unknown FilterDAWGS key engine" );
+			}
+		} // namespace
+
+		GenericImage<rgb3>
+		FilterDAWGS::filter( ImageView<rgb3> const &input_image,
+		                     FilterDAWGS::key_engines const key_engine ) {
+			return dawgs<rgb3>( input_image, key_engine );
+		}
+
+		GenericImage<rgb3>
+		FilterDAWGS::filter( GenericImage<rgb3> const &input_image,
+		                     FilterDAWGS::key_engines const key_engine ) {
+			return dawgs<rgb3>( input_image.view( ), key_engine );
+		}
+
+		Future<GenericImage<rgb3>>
+		FilterDAWGS::filter_async( GenericImage<rgb3> input_image,
+		                           FilterDAWGS::key_engines const key_engine ) {
+			return run_async(
+			  [input_image = std::move( input_image ), key_engine]( ) {
+				  return filter( input_image, key_engine );
 			  } );
+		}
+
+		GenericImage<rgb3>
+		FilterDAWGS::filter( OrientedView<rgb3> const &input_image,
+		                     FilterDAWGS::key_engines const key_engine ) {
+			return dawgs<rgb3>( input_image, key_engine );
+		}
 
+		GenericImage<uint8_t>
+		FilterDAWGS::filter_gs( ImageView<rgb3> const &input_image,
+		                        FilterDAWGS::key_engines const key_engine ) {
+			return dawgs<uint8_t>( input_image, key_engine );
+		}
+
+		GenericImage<uint8_t>
+		FilterDAWGS::filter_gs( GenericImage<rgb3> const &input_image,
+		                        FilterDAWGS::key_engines const key_engine ) {
+			return dawgs<uint8_t>( input_image.view( ), key_engine );
+		}
+
+		GenericImage<uint8_t>
+		FilterDAWGS::filter_gs( OrientedView<rgb3> const &input_image,
+		                        FilterDAWGS::key_engines const key_engine ) {
+			return dawgs<uint8_t>( input_image, key_engine );
+		}
+
+		GenericImage<uint8_t>
+		FilterDAWGS::filter_gs( PlanarImage<uint8_t> const &input_image ) {
+			auto const keys = bitset_keys( input_image );
+			GenericImage<uint8_t> output_image{input_image.width( ),
+			                                   input_image.height( ), no_init};
+			auto const chunks = impl::chunk_count( input_image.size( ), 1U << 16U );
+
+			if( keys.size( ) <= 256 ) {
+				DAW_TRACE_SPAN( "FilterDAWGS::mapping" );
+				impl::for_each_chunk(
+				  input_image.size( ), chunks,
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  auto const *const red = input_image.red( );
+					  auto const *const green = input_image.green( );
+					  auto const *const blue = input_image.blue( );
+					  for( size_t n = first; n < last; ++n ) {
+						  output_image[n] = static_cast<uint8_t>(
+						    helpers::too_gs_small( red[n], green[n], blue[n] ) );
+					  }
+				  } );
+				return output_image;
+			}
+
+			auto const bin_map = build_bin_map( keys );
+			DAW_TRACE_SPAN( "FilterDAWGS::mapping" );
+			impl::for_each_chunk(
+			  input_image.size( ), chunks,
+			  [&]( size_t, size_t const first, size_t const last ) {
+				  for_each_key_block(
+				    input_image, first, last,
+				    [&]( uint32_t const *block, size_t const count, size_t const pos ) {
+					    bin_map.map( block, block + count, &output_image[pos],
+					                 []( uint32_t const key ) { return key; } );
+				    } );
+			  } );
 			return output_image;
 		}
 
+		void FilterDAWGS::filter_bands( size_t const width, size_t const height,
+		                                read_band_t const &read_band,
+		                                write_band_t const &write_band,
+		                                size_t const band_rows ) {
+			daw::exception::daw_throw_on_false( band_rows > 0,
+			                                    "band_rows must be non-zero" );
+
+			image_vector<rgb3> band( width *
+			                                   std::min( band_rows, height ) );
+			image_vector<uint8_t> levels( band.size( ) );
+
+			// Calls func( first_row, band_view ) for every band of the source
+			auto const for_each_band = [&]( auto func ) {
+				for( size_t first_row = 0; first_row < height; first_row += band_rows ) {
+					auto const row_count = std::min( band_rows, height - first_row );
+					{
+						DAW_TRACE_SPAN( "FilterDAWGS::read_band" );
+						read_band( first_row, row_count, band.data( ) );
+					}
+					func( first_row, ImageView<rgb3>( band.data( ), width, row_count,
+					                                  width * sizeof( rgb3 ) ) );
+				}
+			};
+
+			// Pass 1: distinct keys
+			auto partials = make_partial_keys( band.size( ) );
+			for_each_band( [&]( size_t, ImageView<rgb3> const &band_view ) {
+				insert_keys( partials, band_view );
+			} );
+			auto const keys = merge_keys( std::move( partials ) );
+
+			// Pass 2: map each band to its output levels
+			auto const map_bands = [&]( auto map_pixels ) {
+				for_each_band(
+				  [&]( size_t const first_row, ImageView<rgb3> const &band_view ) {
+					  map_rows( band_view, map_pixels, [&]( size_t const y ) {
+						  return levels.data( ) + y * width;
+					  } );
+					  DAW_TRACE_SPAN( "FilterDAWGS::write_band" );
+					  write_band( first_row, band_view.height( ), levels.data( ) );
+				  } );
+			};
+
+			if( keys.size( ) <= 256 ) {
+				map_bands(
+				  []( rgb3 const *first, rgb3 const *const last, uint8_t *out ) {
+					  map_small_gs( first, last, out );
+				  } );
+				return;
+			}
+			auto const bin_map = build_bin_map( keys );
+			map_bands( [&bin_map]( rgb3 const *first, rgb3 const *const last,
+			                       uint8_t *out ) {
+				bin_map.map( first, last, out, []( rgb3 const &rgb ) {
+					return FilterDAWGS::too_gs( rgb );
+				} );
+			} );
+		}
+
+		void FilterDAWGS::filter_netpbm( daw::string_view input_filename,
+		                                 daw::string_view output_filename,
+		                                 size_t const band_rows ) {
+			NetpbmReader reader{input_filename};
+			NetpbmWriter writer{output_filename, reader.width( ), reader.height( )};
+
+			filter_bands(
+			  reader.width( ), reader.height( ),
+			  [&reader]( size_t const first_row, size_t const row_count,
+			             rgb3 *rows ) { reader.read_rows( first_row, row_count, rows ); },
+			  [&writer]( size_t const first_row, size_t const row_count,
+			             uint8_t const *levels ) {
+				  writer.write_rows( first_row, row_count, levels );
+			  },
+			  band_rows );
+			writer.close( );
+		}
+
 #ifdef DAWFILTER_USEPYTHON
 		void FilterDAWGS::register_python( std::string const nameoftype ) {
-			boost::python::def( nameoftype.c_str( ), &FilterDAWGS::filter );
+			using filter_t = GenericImage<rgb3> ( * )( GenericImage<rgb3> const &,
+			                                           key_engines const );
+			boost::python::def( nameoftype.c_str( ),
+			                    static_cast<filter_t>( &FilterDAWGS::filter ) );
 		}
 #endif
 	} // namespace imaging
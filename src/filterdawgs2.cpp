@@ -21,179 +21,125 @@
 // SOFTWARE.
 
 #include <algorithm>
-#include <cmath>
-#include <iterator>
-#include <map>
+#include <cstdint>
 #include <numeric>
-#include <stdexcept>
-#include <tuple>
-#include <unordered_map>
-#include <utility>
 #include <vector>
 
-#include <daw/daw_array.h>
-#include <daw/daw_bounded_array.h>
-#include <daw/daw_container_algorithm.h>
-#include <daw/daw_exception.h>
-#include <daw/daw_math.h>
-#include <daw/daw_utility.h>
-
+#include "dawgs2lut.h"
 #include "filterdawgs2.h"
 #include "genericimage.h"
 #include "genericrgb.h"
+#include "imagebuffer.h"
+#include "parallelchunks.h"
+#include "trace.h"
 
 namespace daw {
 	namespace imaging {
 		namespace {
-			template<typename Map>
-			auto get_keys( Map const &m ) {
-				std::vector<typename Map::key_type> result{};
-				result.reserve( m.size( ) );
-				daw::container::transform(
-				  m, std::back_inserter( result ),
-				  []( auto const &val ) { return val.first; } );
+			// Sum each channel in parallel.  The sums are integers so the result
+			// does not depend on how the rows are split
+			DAWGS2Sums sum_channels( GenericImage<rgb3> const &image_input,
+			                         size_t const chunks ) {
+				DAW_TRACE_SPAN( "FilterDAWGS2::sums" );
+				image_vector<DAWGS2Sums> partials( chunks );
+				impl::for_each_chunk(
+				  image_input.height( ), chunks,
+				  [&]( size_t const chunk, size_t const first, size_t const last ) {
+					  DAWGS2Sums partial{};
+					  for( size_t y = first; y < last; ++y ) {
+						  partial.add( image_input.row( y ), image_input.width( ) );
+					  }
+					  partials[chunk] = partial;
+				  } );
+				DAWGS2Sums result{};
+				for( auto const &partial : partials ) {
+					result += partial;
+				}
 				return result;
 			}
 
-			template<typename T>
-			constexpr T const const_under_half = T(
-			  0.49999999999999999999999999999999999999999999999999999999999999999999999999999999 );
-
-			namespace impl {
-				namespace {
-					template<typename T>
-					constexpr auto coefficients( ) noexcept {
-						auto const sqrt_tmp = sqrt( static_cast<T>( 0.125 ) );
-						auto const pi_over_64 = daw::math::PI<T> / static_cast<T>( 64.0 );
-						daw::bounded_array_t<T, 64> result;
-						for( size_t j = 0; j < 8; ++j ) {
-							result[j] = sqrt_tmp;
-							for( size_t i = 8; i < 64; i += 8 ) {
-								auto rad = static_cast<T>( i ) *
-								           ( static_cast<T>( j ) + static_cast<T>( 0.5 ) ) *
-								           pi_over_64;
-								result[i + j] = static_cast<T>( 0.5 ) * daw::math::cos( rad );
-							}
-						}
-						return result;
-					}
-				} // namespace
-
-				template<typename T, typename U>
-				void coeffs( T &Cu, T &Cv, U u, U v ) {
-					Cu = u == 0 ? 1.0 / sqrt( 2.0 ) : 1.0;
-					Cv = v == 0 ? 1.0 / sqrt( 2.0 ) : 1.0;
+			DAWGS2Sums sum_planes( PlanarImage<uint8_t> const &image_input,
+			                       size_t const chunks ) {
+				DAW_TRACE_SPAN( "FilterDAWGS2::sums" );
+				image_vector<DAWGS2Sums> partials( chunks );
+				impl::for_each_chunk(
+				  image_input.size( ), chunks,
+				  [&]( size_t const chunk, size_t const first, size_t const last ) {
+					  auto const sum_plane = [first, last]( uint8_t const *plane ) {
+						  return std::accumulate( plane + first, plane + last,
+						                          static_cast<uintmax_t>( 0 ) );
+					  };
+					  partials[chunk] = DAWGS2Sums{sum_plane( image_input.red( ) ),
+					                               sum_plane( image_input.green( ) ),
+					                               sum_plane( image_input.blue( ) )};
+				  } );
+				DAWGS2Sums result{};
+				for( auto const &partial : partials ) {
+					result += partial;
 				}
-			} // namespace impl
-
-			template<typename T>
-			GenericImage<double> dct( GenericImage<T> const &image, size_t const xpos,
-			                          size_t const ypos ) {
-				GenericImage<double> data( 8, 8 );
-				for( size_t v = 0; v < 8; v++ ) {
-					for( size_t u = 0; u < 8; u++ ) {
-						double Cu = 0;
-						double Cv = 0;
-						double z = 0.0;
-
-						impl::coeffs( Cu, Cv, u, v );
-
-						for( size_t y = 0; y < 8; y++ ) {
-							for( size_t x = 0; x < 8; x++ ) {
-								auto s = static_cast<double>( image( x + xpos, y + ypos ) );
-
-								auto q = s *
-								         cos( static_cast<double>( ( 2 * x + 1 ) * u ) *
-								              daw::math::PI<double> / 16.0 ) *
-								         cos( static_cast<double>( ( 2 * y + 1 ) * v ) *
-								              daw::math::PI<double> / 16.0 );
-								z += q;
-							}
-						}
-						data( v, u ) = 0.25 * Cu * Cv * z;
-					}
-				}
-				return data;
+				return result;
 			}
 
-			template<typename T>
-			void idct( GenericImage<T> &image, GenericImage<double> const &dct_data,
-			           size_t const xpos, size_t const ypos ) {
-				// iDCT
-				for( size_t y = 0; y < 8; y++ ) {
-					for( size_t x = 0; x < 8; x++ ) {
-						double z = 0.0;
-
-						for( size_t v = 0; v < 8; v++ ) {
-							for( size_t u = 0; u < 8; u++ ) {
-								double Cu = 0.0;
-								double Cv = 0.0;
-
-								impl::coeffs( Cu, Cv, u, v );
-								auto S = dct_data( v, u );
-
-								auto q = Cu * Cv * S *
-								         cos( static_cast<double>( ( 2 * x + 1 ) * u ) *
-								              daw::math::PI<double> / 16.0 ) *
-								         cos( static_cast<double>( ( 2 * y + 1 ) * v ) *
-								              daw::math::PI<double> / 16.0 );
-								z += q;
-							}
-						}
-
-						z /= 4.0;
-						if( z > std::numeric_limits<T>::max( ) ) {
-							image( x + xpos, y + ypos ) = std::numeric_limits<T>::max( );
-						} else if( z < 0 ) {
-							image( x + xpos, y + ypos ) = 0;
-						} else {
-							image( x + xpos, y + ypos ) = static_cast<T>( z );
-						}
-					}
-				}
+			// Out is rgb3 or uint8_t
+			template<typename Out>
+			GenericImage<Out> dawgs2( GenericImage<rgb3> const &image_input ) {
+				auto const chunks = impl::chunk_count( image_input.height( ), 16 );
+				auto const lut = DAWGS2LUT::from_sums(
+				  sum_channels( image_input, chunks ), image_input.size( ) );
+
+				DAW_TRACE_SPAN( "FilterDAWGS2::mapping" );
+				GenericImage<Out> image_output( image_input.width( ),
+				                                image_input.height( ), no_init );
+				impl::for_each_chunk(
+				  image_input.height( ), chunks,
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t y = first; y < last; ++y ) {
+						  auto const *const in = image_input.row( y );
+						  auto *const out = image_output.row( y );
+						  for( size_t x = 0; x < image_input.width( ); ++x ) {
+							  out[x] = Out( lut( in[x] ) );
+						  }
+					  }
+				  } );
+				return image_output;
 			}
-
 		} // namespace
 
 		GenericImage<rgb3>
 		FilterDAWGS2::filter( GenericImage<rgb3> const &image_input ) {
+			return dawgs2<rgb3>( image_input );
+		}
 
-			auto sum =
-			  std::accumulate( image_input.begin( ), image_input.end( ),
-			                   std::tuple<uintmax_t, uintmax_t, uintmax_t>{0, 0, 0},
-			                   []( auto init, auto const &current ) {
-				                   std::get<0>( init ) += current.red;
-				                   std::get<1>( init ) += current.green;
-				                   std::get<2>( init ) += current.blue;
-				                   return std::move( init );
-			                   } );
-
-			std::get<0>( sum ) /= image_input.size( );
-			std::get<1>( sum ) /= image_input.size( );
-			std::get<2>( sum ) /= image_input.size( );
-
-			GenericImage<rgb3> image_output( image_input.width( ),
-			                                 image_input.height( ) );
+		Future<GenericImage<rgb3>>
+		FilterDAWGS2::filter_async( GenericImage<rgb3> image_input ) {
+			return run_async( [image_input = std::move( image_input )]( ) {
+				return filter( image_input );
+			} );
+		}
 
-			auto mx = static_cast<double>( std::max(
-			  {std::get<0>( sum ), std::get<1>( sum ), std::get<2>( sum )} ) );
-			auto weight_red = static_cast<double>( std::get<0>( sum ) ) / mx;
-			auto weight_green = static_cast<double>( std::get<1>( sum ) ) / mx;
-			auto weight_blue = static_cast<double>( std::get<2>( sum ) ) / mx;
-			auto dv = ( weight_red + weight_green + weight_blue ) / 3.0;
+		GenericImage<uint8_t>
+		FilterDAWGS2::filter_gs( GenericImage<rgb3> const &image_input ) {
+			return dawgs2<uint8_t>( image_input );
+		}
 
-			daw::exception::daw_throw_on_false( image_input.size( ) <=
-			                                    image_output.size( ) );
-			// TODO: make parallel
-			daw::container::transform(
-			  image_input, image_output.begin( ), [&]( rgb3 const &rgb ) {
-				  auto result = static_cast<uint8_t>(
-				    ( ( static_cast<double>( rgb.red ) / weight_red +
-				        static_cast<double>( rgb.green ) / weight_green +
-				        static_cast<double>( rgb.blue ) / weight_blue ) /
-				      dv ) /
-				    3.0 );
-				  return result;
+		GenericImage<uint8_t>
+		FilterDAWGS2::filter_gs( PlanarImage<uint8_t> const &image_input ) {
+			auto const size = image_input.size( );
+			auto const chunks = impl::chunk_count( size, 1U << 16U );
+			auto const lut =
+			  DAWGS2LUT::from_sums( sum_planes( image_input, chunks ), size );
+
+			DAW_TRACE_SPAN( "FilterDAWGS2::mapping" );
+			GenericImage<uint8_t> image_output( image_input.width( ),
+			                                    image_input.height( ), no_init );
+			impl::for_each_chunk(
+			  size, chunks, [&]( size_t, size_t const first, size_t const last ) {
+				  auto const *const red = image_input.red( );
+				  auto const *const green = image_input.green( );
+				  auto const *const blue = image_input.blue( );
+				  for( size_t n = first; n < last; ++n ) {
+					  image_output[n] = lut( red[n], green[n], blue[n] );
+				  }
 			  } );
 			return image_output;
 		}
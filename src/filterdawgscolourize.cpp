@@ -20,339 +20,199 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include <cmath>
-#include <limits>
+#include <algorithm>
 #include <map>
-
-#include <daw/daw_algorithm.h>
-#include <daw/daw_container_algorithm.h>
-#include <daw/daw_exception.h>
-#include <daw/daw_math.h>
+#include <vector>
 
 #include "filterdawgscolourize.h"
 #include "genericimage.h"
 #include "genericrgb.h"
-#include "helpers.h"
+#include "imagebuffer.h"
+#include "parallelchunks.h"
+#include "repaintkernels.h"
+#include "trace.h"
 
 namespace daw {
 	namespace imaging {
 		namespace {
-			constexpr float colour_calc( float c, float t1, float t2 ) noexcept {
-				if( c < 0.0f ) {
-					c += 1.0f;
-				} else if( c > 1.0f ) {
-					c -= 1.0f;
-				}
-				if( 6.0f * c < 1.0f ) {
-					return t1 + ( t2 - t1 ) * 6.0f * c;
-				} else if( 2.0f * c < 1.0f ) {
-					return t2;
-				} else if( 3.0f * c < 2.0f ) {
-					return t1 + ( t2 - t1 ) * ( 2.0f / 3.0f - c ) * 6.0f;
+			// Call func( x, count, result ) for each block of repainted pixels in
+			// row y
+			template<typename Formula, typename GS, typename Func>
+			void for_each_repaint_block( GenericImage<rgb3> const &input_image,
+			                             GenericImage<GS> const &input_gsimage,
+			                             size_t const y, Func func ) {
+				Formula const repaint{};
+				impl::repaint_block block;
+				impl::repaint_result result;
+				auto const *const orig = input_image.row( y );
+				auto const *const gs = input_gsimage.row( y );
+				auto const width = input_image.width( );
+				for( size_t x = 0; x < width; x += impl::repaint_lanes ) {
+					auto const count = std::min( impl::repaint_lanes, width - x );
+					impl::load_repaint_block( orig + x, gs + x, count, block );
+					repaint( block, result );
+					func( x, count, result );
 				}
-				return t1;
-			}
-
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_ratio( GenericImage<rgb3> const &input_image,
-			               GenericImage<rgb3> const &input_gsimage ) {
-				daw::exception::daw_throw_on_false( input_image.size( ) ==
-				                                    input_gsimage.size( ) );
-				GenericImage<GenericRGB<uint32_t>> output_image(
-				  input_image.width( ), input_image.height( ) );
-				daw::algorithm::transform_many(
-				  input_image.begin( ), input_image.end( ), input_gsimage.begin( ),
-				  output_image.begin( ), []( rgb3 orig, rgb3 const grayscale3 ) {
-					  uint8_t grayscale = grayscale3.blue;
-					  // Luma = Rx + Gy +Bz
-					  // We want Luma -> Luma2
-					  // ( Rx + Gy + Bz )/Luma = 1
-					  // Luma2*( Rx + Gy + Bz )/Luma = Luma2
-					  GenericRGB<float> forig( static_cast<float>( orig.red ),
-					                           static_cast<float>( orig.green ),
-					                           static_cast<float>( orig.blue ) );
-
-					  auto const curL = forig.too_float_gs( );
-
-					  if( fabs( static_cast<double>( curL ) ) < 0.114 ) {
-						  // prevent div by 0 as 0.114 is the minimum value;
-						  return GenericRGB<uint32_t>( 0, 0, 0 );
-					  }
-					  auto const rat = static_cast<float>( grayscale ) / curL;
-					  auto red_tmp = daw::math::round<uint32_t>( forig.red * rat );
-					  auto green_tmp = daw::math::round<uint32_t>( forig.green * rat );
-					  auto blue_tmp = daw::math::round<uint32_t>( forig.blue * rat );
-					  return GenericRGB<uint32_t>( red_tmp, green_tmp, blue_tmp );
-				  } );
-				return output_image;
-			}
-
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_yuv( GenericImage<rgb3> const &input_image,
-			             GenericImage<rgb3> const &input_gsimage ) {
-				daw::exception::daw_throw_on_false( input_image.size( ) ==
-				                                    input_gsimage.size( ) );
-				GenericImage<GenericRGB<uint32_t>> output_image(
-				  input_image.width( ), input_image.height( ) );
-				daw::algorithm::transform_many(
-				  input_image.begin( ), input_image.end( ), input_gsimage.begin( ),
-				  output_image.begin( ), []( rgb3 orig, rgb3 const grayscale3 ) {
-					  uint8_t grayscale = grayscale3.blue;
-					  // YUV
-					  // Convert back to YUV with Y being the current grayscale value and
-					  // then back to RGB uint32_t const retval = 19595*pixel.red +
-					  // 38469*pixel.green + 7471*pixel.blue;
-					  auto const Y = static_cast<float>( grayscale );
-					  auto const U = orig.colform( -0.147f, -0.289f, 0.436f );
-					  auto const V = orig.colform( 0.615f, -0.515f, -0.1f );
-
-					  auto const R = static_cast<uint32_t>( Y + 1.14f * V );
-					  auto const G = static_cast<uint32_t>( Y - 0.395f * U - 0.581f * V );
-					  auto const B = static_cast<uint32_t>( Y + 2.032f * U );
-					  // int B = (uint32_t)( Y + 1.5f*U );
-					  return GenericRGB<uint32_t>( R, G, B );
-				  } );
-				return output_image;
-			}
-
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_multiply_1( GenericImage<rgb3> const &input_image,
-			                    GenericImage<rgb3> const &input_gsimage ) {
-				daw::exception::daw_throw_on_false( input_image.size( ) ==
-				                                    input_gsimage.size( ) );
-				GenericImage<GenericRGB<uint32_t>> output_image(
-				  input_image.width( ), input_image.height( ) );
-				daw::algorithm::transform_many(
-				  input_image.begin( ), input_image.end( ), input_gsimage.begin( ),
-				  output_image.begin( ), []( rgb3 orig, rgb3 const grayscale3 ) {
-					  uint8_t grayscale = grayscale3.blue;
-					  return GenericRGB<uint32_t>( orig.red * grayscale,
-					                               orig.green * grayscale,
-					                               orig.blue * grayscale );
-				  } );
-				return output_image;
-			}
-
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_addition( GenericImage<rgb3> const &input_image,
-			                  GenericImage<rgb3> const &input_gsimage ) {
-				daw::exception::daw_throw_on_false( input_image.size( ) ==
-				                                    input_gsimage.size( ) );
-				GenericImage<GenericRGB<uint32_t>> output_image(
-				  input_image.width( ), input_image.height( ) );
-				daw::algorithm::transform_many(
-				  input_image.begin( ), input_image.end( ), input_gsimage.begin( ),
-				  output_image.begin( ), []( rgb3 orig, rgb3 const grayscale3 ) {
-					  uint8_t grayscale = grayscale3.blue;
-					  return GenericRGB<uint32_t>( orig.red + grayscale,
-					                               orig.green + grayscale,
-					                               orig.blue + grayscale );
-				  } );
-				return output_image;
-			}
-
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_multiply_2( GenericImage<rgb3> const &input_image,
-			                    GenericImage<rgb3> const &input_gsimage ) {
-				daw::exception::daw_throw_on_false( input_image.size( ) ==
-				                                    input_gsimage.size( ) );
-				GenericImage<GenericRGB<uint32_t>> output_image(
-				  input_image.width( ), input_image.height( ) );
-				daw::algorithm::transform_many(
-				  input_image.begin( ), input_image.end( ), input_gsimage.begin( ),
-				  output_image.begin( ), []( rgb3 orig, rgb3 const grayscale3 ) {
-					  uint8_t grayscale = grayscale3.blue;
-					  // Mul 2, Mul with individual scaling based on max( R, G, B )
-					  auto const maxval = static_cast<float>( orig.max( ) );
-					  if( 0 <= maxval ) {
-						  return GenericRGB<uint32_t>( 0, 0, 0 );
-					  }
-					  auto const luma = static_cast<float>( grayscale );
-					  auto red = static_cast<uint32_t>(
-					    ( static_cast<float>( orig.red ) * luma ) / maxval );
-					  auto green = static_cast<uint32_t>(
-					    ( static_cast<float>( orig.green ) * luma ) / maxval );
-					  auto blue = static_cast<uint32_t>(
-					    ( static_cast<float>( orig.blue ) * luma ) / maxval );
-					  return GenericRGB<uint32_t>( std::move( red ), std::move( green ),
-					                               std::move( blue ) );
-				  } );
-				return output_image;
 			}
 
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_hsl( GenericImage<rgb3> const &input_image,
-			             GenericImage<rgb3> const &input_gsimage ) {
-				daw::exception::daw_throw_on_false( input_image.size( ) ==
-				                                    input_gsimage.size( ) );
-				GenericImage<GenericRGB<uint32_t>> output_image(
-				  input_image.width( ), input_image.height( ) );
-				daw::algorithm::transform_many(
-				  input_image.begin( ), input_image.end( ), input_gsimage.begin( ),
-				  output_image.begin( ), []( rgb3 orig, rgb3 const grayscale3 ) {
-					  uint8_t grayscale = grayscale3.blue;
-					  // HSL
-					  auto luma = static_cast<float>( grayscale ) / 255.0f;
-					  auto hue = 0.0f;
-					  auto saturation = 0.0f;
-					  auto const orig_max = orig.max( );
-					  auto const orig_min = orig.min( );
-
-					  if( 0 == grayscale ) {
-						  return GenericRGB<uint32_t>( 0, 0, 0 );
-					  } else if( orig_max == orig_min ) {
-						  return GenericRGB<uint32_t>( static_cast<uint32_t>( grayscale ) );
-					  } else {
-						  {
-							  auto const orig_maxf = static_cast<float>( orig_max ) / 255.0f;
-							  auto const orig_minf = static_cast<float>( orig_min ) / 255.0f;
-							  auto const orig_range =
-							    0 == orig_max - orig_min
-							      ? std::numeric_limits<float>::epsilon( )
-							      : orig_maxf - orig_minf;
-							  saturation = orig_range;
-							  auto L = ( orig_maxf + orig_minf ) / 2.0f;
-							  GenericRGB<float> rgb(
-							    static_cast<float>( orig.red ) / 255.0f,
-							    static_cast<float>( orig.green ) / 255.0f,
-							    static_cast<float>( orig.blue ) / 255.0f );
-
-							  if( 0 != orig_max - orig_min ) {
-								  if( L < 0.5f ) {
-									  saturation = ( orig_range / ( orig_maxf + orig_minf ) );
-								  } else {
-									  saturation =
-									    ( orig_range / ( 2.0f - orig_maxf - orig_minf ) );
-								  }
-
-								  if( orig_max == orig.red ) {
-									  hue = ( rgb.green - rgb.blue ) / orig_range;
-								  } else if( orig_max == orig.green ) {
-									  hue = 2.0f + ( rgb.blue - rgb.red ) / orig_range;
-								  } else if( orig_max == orig.blue ) {
-									  hue = 4.0f + ( rgb.red - rgb.green ) / orig_range;
-								  }
-							  }
-						  }
-						  GenericRGB<float> rgb( 0.0f );
-						  float t1, t2;
-						  float th = hue / 6.0f;
-						  if( luma < 0.5f ) {
-							  t2 = luma * ( 1.0f + saturation );
-						  } else {
-							  t2 = ( luma + saturation ) - ( luma * saturation );
+			template<typename Formula, typename GS>
+			GenericImage<rgb3> colourize( GenericImage<rgb3> const &input_image,
+			                              GenericImage<GS> const &input_gsimage ) {
+				// Valid data checks - Start
+				if( input_image.width( ) != input_gsimage.width( ) ) {
+					auto const msg =
+					  "FilterDAWGSColourize::runfilter with input_image->width "
+					  "!= _input_gsimage->width";
+					throw std::runtime_error( msg );
+				}
+				if( input_image.height( ) != input_gsimage.height( ) ) {
+					auto const msg =
+					  "FilterDAWGSColourize::runfilter with input_image->height "
+					  "!= _input_gsimage->height";
+					throw std::runtime_error( msg );
+				}
+				// Valid data checks - End
+
+				auto const height = input_image.height( );
+				auto const chunks = impl::chunk_count( height, 16 );
+
+				// The repainted image is never stored.  The first pass only tracks
+				// the per channel range and the second recomputes each pixel while
+				// normalising it into that range.  Both passes split the rows into
+				// chunks, the first keeps a min/max partial per chunk that is merged
+				// afterwards
+				impl::repaint_range range{};
+				{
+					DAW_TRACE_SPAN( "FilterDAWGSColourize::range" );
+					image_vector<impl::repaint_range> partials( chunks );
+
+					impl::for_each_chunk(
+					  height, chunks,
+					  [&]( size_t const chunk, size_t const first, size_t const last ) {
+						  impl::repaint_range partial{};
+						  for( size_t y = first; y < last; ++y ) {
+							  for_each_repaint_block<Formula>(
+							    input_image, input_gsimage, y,
+							    [&]( size_t, size_t const count,
+							         impl::repaint_result const &result ) {
+								    partial.add( result, count );
+							    } );
 						  }
-						  t1 = 2.0f * luma - t2;
-
-						  rgb.red = th + ( 1.0f / 3.0f );
-						  rgb.green = th;
-						  rgb.blue = th - ( 1.0f / 3.0f );
+						  partials[chunk] = partial;
+					  } );
 
-						  rgb.red = colour_calc( rgb.red, t1, t2 );
-						  rgb.green = colour_calc( rgb.green, t1, t2 );
-						  rgb.blue = colour_calc( rgb.blue, t1, t2 );
-
-						  rgb.mul( 255.0f );
-
-						  return GenericRGB<uint32_t>( static_cast<uint32_t>( rgb.red ),
-						                               static_cast<uint32_t>( rgb.green ),
-						                               static_cast<uint32_t>( rgb.blue ) );
+					for( auto const &partial : partials ) {
+						range.merge( partial );
+					}
+				}
+				auto const scale = range.scale( );
+
+				DAW_TRACE_SPAN( "FilterDAWGSColourize::normalise" );
+				GenericImage<rgb3> output_image( input_image.width( ), height,
+				                                 no_init );
+				impl::for_each_chunk(
+				  height, chunks,
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t y = first; y < last; ++y ) {
+						  auto *const out = output_image.row( y );
+						  for_each_repaint_block<Formula>(
+						    input_image, input_gsimage, y,
+						    [&]( size_t const x, size_t const count,
+						         impl::repaint_result const &result ) {
+							    impl::normalise_repaint( result, count, range, scale,
+							                             out + x );
+						    } );
 					  }
 				  } );
 				return output_image;
 			}
-			using rp_func_t = GenericImage<GenericRGB<uint32_t>> ( * )(
-			  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
-			GenericImage<GenericRGB<uint32_t>>
-			repaint_image( FilterDAWGSColourize::repaint_formulas repaint_formula,
-			               GenericImage<rgb3> const &input_image,
-			               GenericImage<rgb3> const &inputgs_image ) {
-				static std::unordered_map<FilterDAWGSColourize::repaint_formulas,
-				                          rp_func_t>
-				  repaint_fn = {
-				    {FilterDAWGSColourize::repaint_formulas::Addition,
-				     repaint_addition},
-				    {FilterDAWGSColourize::repaint_formulas::HSL, repaint_hsl},
-				    {FilterDAWGSColourize::repaint_formulas::Multiply_1,
-				     repaint_multiply_1},
-				    {FilterDAWGSColourize::repaint_formulas::Multiply_2,
-				     repaint_multiply_2},
-				    {FilterDAWGSColourize::repaint_formulas::Ratio, repaint_ratio},
-				    {FilterDAWGSColourize::repaint_formulas::YUV, repaint_yuv},
-				  };
-				return repaint_fn[repaint_formula]( input_image, inputgs_image );
-			}
 
-			template<typename T>
-			constexpr std::pair<GenericRGB<T>, GenericRGB<T>>
-			minmax_element( GenericImage<GenericRGB<T>> const &img ) noexcept {
-				std::pair<GenericRGB<T>, GenericRGB<T>> result{
-				  {std::numeric_limits<T>::max( ), std::numeric_limits<T>::max( ),
-				   std::numeric_limits<T>::max( )},
-				  {std::numeric_limits<T>::min( ), std::numeric_limits<T>::min( ),
-				   std::numeric_limits<T>::min( )}};
-
-				// Do not parallelize without accounting for shared data
-				for( auto const &rgb : img ) {
-					min( rgb, result.first );
-					max( rgb, result.second );
+			template<typename GS>
+			GenericImage<rgb3>
+			colourize( GenericImage<rgb3> const &input_image,
+			           GenericImage<GS> const &input_gsimage,
+			           FilterDAWGSColourize::repaint_formulas repaint_formula ) {
+				switch( repaint_formula ) {
+				case FilterDAWGSColourize::repaint_formulas::Ratio:
+					return colourize<repaint::ratio>( input_image, input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::YUV:
+					return colourize<repaint::yuv>( input_image, input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::Multiply_1:
+					return colourize<repaint::multiply_1>( input_image, input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::Addition:
+					return colourize<repaint::addition>( input_image, input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::Multiply_2:
+					return colourize<repaint::multiply_2>( input_image, input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::HSL:
+					return colourize<repaint::hsl>( input_image, input_gsimage );
 				}
-				return result;
+				throw std::runtime_error( "Unknown repaint formula" );
 			}
-
 		} // namespace
 
 		GenericImage<rgb3> FilterDAWGSColourize::filter(
 		  GenericImage<rgb3> const &input_image,
 		  GenericImage<rgb3> const &input_gsimage,
 		  FilterDAWGSColourize::repaint_formulas repaint_formula ) {
-			// Valid data checks - Start
-			if( input_image.width( ) != input_gsimage.width( ) ) {
-				auto const msg =
-				  "FilterDAWGSColourize::runfilter with input_image->width "
-				  "!= _input_gsimage->width";
-				throw std::runtime_error( msg );
-			}
-			if( input_image.height( ) != input_gsimage.height( ) ) {
-				auto const msg =
-				  "FilterDAWGSColourize::runfilter with input_image->height "
-				  "!= _input_gsimage->height";
-				throw std::runtime_error( msg );
-			}
-			// Valid data checks - End
-
-			auto tmpimgdata =
-			  repaint_image( repaint_formula, input_image, input_gsimage );
-
-			GenericRGB<uint32_t> pd_min{};
-			GenericRGB<uint32_t> pd_max{};
-			std::tie( pd_min, pd_max ) = minmax_element( tmpimgdata );
-
-			auto const mul_fact =
-			  255.0f / static_cast<float>( pd_max.max( ) - pd_min.min( ) );
+			return colourize( input_image, input_gsimage, repaint_formula );
+		}
 
-			GenericImage<rgb3> output_image( input_image.width( ),
-			                                 input_image.height( ) );
+		GenericImage<rgb3> FilterDAWGSColourize::filter(
+		  GenericImage<rgb3> const &input_image,
+		  GenericImage<uint8_t> const &input_gsimage,
+		  FilterDAWGSColourize::repaint_formulas repaint_formula ) {
+			return colourize( input_image, input_gsimage, repaint_formula );
+		}
 
-			daw::container::transform(
-			  tmpimgdata, output_image.begin( ), [&]( auto const &rgb ) {
-				  GenericRGB<uint32_t> cur_value;
+		Future<GenericImage<rgb3>> FilterDAWGSColourize::filter_async(
+		  GenericImage<rgb3> input_image, GenericImage<uint8_t> input_gsimage,
+		  FilterDAWGSColourize::repaint_formulas repaint_formula ) {
+			return run_async( [input_image = std::move( input_image ),
+			                   input_gsimage = std::move( input_gsimage ),
+			                   repaint_formula]( ) {
+				return colourize( input_image, input_gsimage, repaint_formula );
+			} );
+		}
 
-				  cur_value.red = static_cast<uint32_t>(
-				    static_cast<float>( rgb.red - pd_min.red ) * mul_fact );
-				  cur_value.green = static_cast<uint32_t>(
-				    static_cast<float>( rgb.green - pd_min.green ) * mul_fact );
-				  cur_value.blue = static_cast<uint32_t>(
-				    static_cast<float>( rgb.blue - pd_min.blue ) * mul_fact );
-				  cur_value.clampvalue( 0, 255 );
-				  return rgb3( static_cast<uint8_t>( cur_value.red ),
-				               static_cast<uint8_t>( cur_value.green ),
-				               static_cast<uint8_t>( cur_value.blue ) );
-			  } );
+		template<typename Formula>
+		GenericImage<rgb3>
+		FilterDAWGSColourize::filter( GenericImage<rgb3> const &input_image,
+		                              GenericImage<rgb3> const &input_gsimage ) {
+			return colourize<Formula>( input_image, input_gsimage );
+		}
 
-			return output_image;
+		template<typename Formula>
+		GenericImage<rgb3>
+		FilterDAWGSColourize::filter( GenericImage<rgb3> const &input_image,
+		                              GenericImage<uint8_t> const &input_gsimage ) {
+			return colourize<Formula>( input_image, input_gsimage );
 		}
 
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::ratio>(
+		  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::ratio>(
+		  GenericImage<rgb3> const &, GenericImage<uint8_t> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::yuv>(
+		  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::yuv>(
+		  GenericImage<rgb3> const &, GenericImage<uint8_t> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::multiply_1>(
+		  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::multiply_1>(
+		  GenericImage<rgb3> const &, GenericImage<uint8_t> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::addition>(
+		  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::addition>(
+		  GenericImage<rgb3> const &, GenericImage<uint8_t> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::multiply_2>(
+		  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::multiply_2>(
+		  GenericImage<rgb3> const &, GenericImage<uint8_t> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::hsl>(
+		  GenericImage<rgb3> const &, GenericImage<rgb3> const & );
+		template GenericImage<rgb3> FilterDAWGSColourize::filter<repaint::hsl>(
+		  GenericImage<rgb3> const &, GenericImage<uint8_t> const & );
+
 		std::unordered_map<std::string, FilterDAWGSColourize::repaint_formulas>
 		FilterDAWGSColourize::get_repaint_formulas( ) {
 			static std::unordered_map<std::string, repaint_formulas> ret = {
@@ -367,8 +227,12 @@ namespace daw {
 
 #ifdef DAWFILTER_USEPYTHON
 		void FilterDAWGSColourize::register_python( ) {
-			boost::python::def( "filter_dawgscolourize",
-			                    &FilterDAWGSColourize::filter );
+			using filter_t = GenericImage<rgb3> ( * )(
+			  GenericImage<rgb3> const &, GenericImage<rgb3> const &,
+			  FilterDAWGSColourize::repaint_formulas const );
+			boost::python::def(
+			  "filter_dawgscolourize",
+			  static_cast<filter_t>( &FilterDAWGSColourize::filter ) );
 		}
 #endif
 	} // namespace imaging
@@ -23,63 +23,253 @@
 #ifdef DAWFILTER_USEPYTHON
 #include <boost/python.hpp>
 #endif
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
+#include <vector>
 
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#include "exiforientation.h"
 #include "filterrotate.h"
 #include "genericimage.h"
 #include "genericrgb.h"
+#include "parallelchunks.h"
+#include "trace.h"
 
 namespace daw {
 	namespace imaging {
+		namespace {
+			void check_angle( uint32_t const angle ) {
+				if( angle > 3 ) {
+					throw std::runtime_error(
+					  "Cannot specify an angle other than 0 to 3 inclusive" );
+				}
+			}
+
+			FREE_IMAGE_JPEG_OPERATION jpeg_operation( uint32_t const angle ) {
+				switch( angle ) {
+				case 1:
+					return FIJPEG_OP_ROTATE_90;
+				case 2:
+					return FIJPEG_OP_ROTATE_180;
+				case 3:
+					return FIJPEG_OP_ROTATE_270;
+				default:
+					return FIJPEG_OP_NONE;
+				}
+			}
+
+			std::vector<uint8_t> read_file( daw::string_view filename ) {
+				std::ifstream file( filename.to_string( ), std::ios::binary );
+				if( !file ) {
+					auto const msg =
+					  "Could not open input image '" + filename.to_string( ) + "'";
+					throw std::runtime_error( msg );
+				}
+				return std::vector<uint8_t>( std::istreambuf_iterator<char>( file ),
+				                             std::istreambuf_iterator<char>( ) );
+			}
+
+			void write_file( daw::string_view filename,
+			                 std::vector<uint8_t> const &bytes ) {
+				std::ofstream file( filename.to_string( ),
+				                    std::ios::binary | std::ios::trunc );
+				file.write( reinterpret_cast<char const *>( bytes.data( ) ),
+				            static_cast<std::streamsize>( bytes.size( ) ) );
+				if( !file ) {
+					auto const msg =
+					  "Error Saving image to file '" + filename.to_string( ) + "'";
+					throw std::runtime_error( msg );
+				}
+			}
+
+			// Square tiles of rotate_tile pixels keep both the rows read and the
+			// rows written of a tile in L1 while it is transposed
+			constexpr size_t rotate_tile = 32;
+
+			// Tiles are transposed in blocks of rotate_block x rotate_block pixels
+			constexpr size_t rotate_block = 4;
+
+#ifdef __SSSE3__
+			// 4 rgb3s.  A 16 byte load is used when the 4 bytes past them are
+			// still before end, the end of the input pixels
+			inline __m128i load_block_row( rgb3 const *const pixels,
+			                               rgb3 const *const end ) noexcept {
+				auto const *const bytes = reinterpret_cast<uint8_t const *>( pixels );
+				if( bytes + 16 <= reinterpret_cast<uint8_t const *>( end ) ) {
+					return _mm_loadu_si128( reinterpret_cast<__m128i const *>( bytes ) );
+				}
+				int32_t tail;
+				std::memcpy( &tail, bytes + 8, sizeof( tail ) );
+				return _mm_unpacklo_epi64(
+				  _mm_loadl_epi64( reinterpret_cast<__m128i const *>( bytes ) ),
+				  _mm_cvtsi32_si128( tail ) );
+			}
+
+			// 4 rgb3s, the 4 bytes past them are not written.  Overlapping 16
+			// byte stores measured slower than this
+			inline void store_block_row( __m128i const value,
+			                             rgb3 *const pixels ) noexcept {
+				auto *const bytes = reinterpret_cast<uint8_t *>( pixels );
+				_mm_storel_epi64( reinterpret_cast<__m128i *>( bytes ), value );
+				auto const tail = _mm_cvtsi128_si32( _mm_srli_si128( value, 8 ) );
+				std::memcpy( bytes + 8, &tail, sizeof( tail ) );
+			}
+
+			// Transpose a block in registers.  source[j] points to the 4 input
+			// pixels of output column j, ordered by output row, or in reverse
+			// order when Reverse is set.  The rows are widened to 4 bytes per
+			// pixel, transposed as 32 bit lanes and narrowed back to rgb3s
+			template<bool Reverse>
+			void transpose_block( rgb3 const *const *source, rgb3 const *const end,
+			                      rgb3 *const *out ) noexcept {
+				auto const widen =
+				  Reverse ? _mm_setr_epi8( 9, 10, 11, -1, 6, 7, 8, -1, 3, 4, 5, -1, 0,
+				                           1, 2, -1 )
+				          : _mm_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9,
+				                           10, 11, -1 );
+				auto const narrow = _mm_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13,
+				                                   14, -1, -1, -1, -1 );
+				__m128i rows[rotate_block];
+				for( size_t j = 0; j < rotate_block; ++j ) {
+					rows[j] = _mm_shuffle_epi8( load_block_row( source[j], end ), widen );
+				}
+				auto const t0 = _mm_unpacklo_epi32( rows[0], rows[1] );
+				auto const t1 = _mm_unpacklo_epi32( rows[2], rows[3] );
+				auto const t2 = _mm_unpackhi_epi32( rows[0], rows[1] );
+				auto const t3 = _mm_unpackhi_epi32( rows[2], rows[3] );
+				store_block_row(
+				  _mm_shuffle_epi8( _mm_unpacklo_epi64( t0, t1 ), narrow ), out[0] );
+				store_block_row(
+				  _mm_shuffle_epi8( _mm_unpackhi_epi64( t0, t1 ), narrow ), out[1] );
+				store_block_row(
+				  _mm_shuffle_epi8( _mm_unpacklo_epi64( t2, t3 ), narrow ), out[2] );
+				store_block_row(
+				  _mm_shuffle_epi8( _mm_unpackhi_epi64( t2, t3 ), narrow ), out[3] );
+			}
+#else
+			template<bool Reverse>
+			void transpose_block( rgb3 const *const *source, rgb3 const *,
+			                      rgb3 *const *out ) noexcept {
+				for( size_t i = 0; i < rotate_block; ++i ) {
+					auto const from = Reverse ? rotate_block - 1 - i : i;
+					for( size_t j = 0; j < rotate_block; ++j ) {
+						out[i][j] = source[j][from];
+					}
+				}
+			}
+#endif
+
+			// Rotations by 90 and 270 degrees.  source( r, c ) points to the input
+			// pixel that lands at output row r, column c.  Output rows r + 1, ...
+			// of that column come from the following input pixels, or from the
+			// preceding ones when Reverse is set.  source_end is one past the last
+			// input pixel.  The output rows are split into bands of tiles across
+			// threads, so every thread writes its own memory, and each band is
+			// walked a tile at a time
+			template<bool Reverse, typename Source>
+			GenericImage<rgb3> rotate_tiled( size_t const out_width,
+			                                 size_t const out_height,
+			                                 rgb3 const *const source_end,
+			                                 Source source ) {
+				GenericImage<rgb3> image_rotated( out_width, out_height, no_init );
+				auto const tile_rows = ( out_height + rotate_tile - 1 ) / rotate_tile;
+				auto const copy_pixels = [&]( size_t const r0, size_t const r1,
+				                              size_t const c0, size_t const c1 ) {
+					for( size_t r = r0; r < r1; ++r ) {
+						auto *const out = image_rotated.row( r );
+						for( size_t c = c0; c < c1; ++c ) {
+							out[c] = *source( r, c );
+						}
+					}
+				};
+				impl::for_each_chunk(
+				  tile_rows, impl::chunk_count( tile_rows, 1 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t r0 = first * rotate_tile;
+					       r0 < std::min( last * rotate_tile, out_height );
+					       r0 += rotate_tile ) {
+						  auto const r1 = std::min( r0 + rotate_tile, out_height );
+						  // Whole blocks, the rest of the tile is copied a pixel at a
+						  // time
+						  auto const block_r1 =
+						    r0 + ( r1 - r0 ) / rotate_block * rotate_block;
+						  for( size_t c0 = 0; c0 < out_width; c0 += rotate_tile ) {
+							  auto const c1 = std::min( c0 + rotate_tile, out_width );
+							  auto const block_c1 =
+							    c0 + ( c1 - c0 ) / rotate_block * rotate_block;
+							  for( size_t r = r0; r < block_r1; r += rotate_block ) {
+								  for( size_t c = c0; c < block_c1; c += rotate_block ) {
+									  auto const offset = Reverse ? rotate_block - 1 : 0;
+									  rgb3 const *const in[rotate_block] = {
+									    source( r, c ) - offset, source( r, c + 1 ) - offset,
+									    source( r, c + 2 ) - offset,
+									    source( r, c + 3 ) - offset};
+									  rgb3 *const out[rotate_block] = {
+									    image_rotated.row( r ) + c,
+									    image_rotated.row( r + 1 ) + c,
+									    image_rotated.row( r + 2 ) + c,
+									    image_rotated.row( r + 3 ) + c};
+									  transpose_block<Reverse>( in, source_end, out );
+								  }
+							  }
+							  copy_pixels( r0, block_r1, block_c1, c1 );
+							  copy_pixels( block_r1, r1, c0, c1 );
+						  }
+					  }
+				  } );
+				return image_rotated;
+			}
+		} // namespace
+
 		GenericImage<rgb3>
 		FilterRotate::filter( GenericImage<rgb3> const &image_input,
 		                      uint32_t const angle ) {
 
-			if( angle > 3 ) {
-				throw std::runtime_error(
-				  "Cannot specify an angle other than 0 to 3 inclusive" );
-			}
+			check_angle( angle );
+			DAW_TRACE_SPAN( "FilterRotate::filter" );
+			auto const width = image_input.width( );
+			auto const height = image_input.height( );
+			auto const *const source_end = height == 0
+			                                 ? image_input.row( 0 )
+			                                 : image_input.row( height - 1 ) + width;
 			switch( angle ) { // 0/default = no rotation, 1 = 90 degrees, 2 = 180
 				                // degrees, 3 = 270 degrees
 			case 1: {
-				GenericImage<rgb3> image_rotated( image_input.height( ),
-				                                  image_input.width( ) );
-				size_t const maxy = image_input.height( ) - 1;
-
-				//#pragma omp parallel for
-				for( size_t y = 0; y < image_input.height( ); ++y ) {
-					for( size_t x = 0; x < image_input.width( ); ++x ) {
-						image_rotated( x, maxy - y ) = image_input( y, x );
-					}
-				}
-				return image_rotated;
+				// in( y, x ) -> out( x, maxy - y )
+				auto const maxy = height - 1;
+				return rotate_tiled<false>( height, width, source_end,
+				                            [&]( size_t const r, size_t const c ) {
+					                            return image_input.row( maxy - c ) + r;
+				                            } );
 			}
 			case 2: {
-				GenericImage<rgb3> image_rotated( image_input.width( ),
-				                                  image_input.height( ) );
-				auto const maxx = image_input.width( ) - 1;
-				auto const maxy = image_input.height( ) - 1;
-				//#pragma omp parallel for
-				for( size_t y = 0; y < image_input.height( ); ++y ) {
-					for( size_t x = 0; x < image_input.width( ); ++x ) {
-						image_rotated( maxy - static_cast<size_t>( y ), maxx - x ) =
-						  image_input( y, x );
-					}
-				}
+				// in( y, x ) -> out( maxy - y, maxx - x ), a reversed copy of each row
+				GenericImage<rgb3> image_rotated( width, height, no_init );
+				impl::for_each_chunk(
+				  height, impl::chunk_count( height, 16 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t y = first; y < last; ++y ) {
+						  auto const *const in = image_input.row( y );
+						  std::reverse_copy( in, in + width,
+						                     image_rotated.row( height - 1 - y ) );
+					  }
+				  } );
 				return image_rotated;
 			}
 			case 3: {
-				GenericImage<rgb3> image_rotated( image_input.height( ),
-				                                  image_input.width( ) );
-				auto const maxx = image_input.width( ) - 1;
-				//#pragma omp parallel for
-				for( size_t y = 0; y < image_input.height( ); ++y ) {
-					for( size_t x = 0; x < image_input.width( ); ++x ) {
-						image_rotated( maxx - x, y ) = image_input( y, x );
-					}
-				}
-				return image_rotated;
+				// in( y, x ) -> out( maxx - x, y )
+				auto const maxx = width - 1;
+				return rotate_tiled<true>( height, width, source_end,
+				                           [&]( size_t const r, size_t const c ) {
+					                           return image_input.row( c ) + ( maxx - r );
+				                           } );
 			}
 			default: { // This is here to catch.  You should not use a rotate of 0
 				std::cerr
@@ -87,15 +277,64 @@ namespace daw {
 				     "original image"
 				  << std::endl;
 
-				GenericImage<rgb3> image_rotated( image_input.height( ),
-				                                  image_input.width( ) );
-				std::copy( image_input.begin( ), image_input.end( ),
-				           image_rotated.begin( ) );
-				return image_rotated;
+				return image_input;
 			}
 			}
 		}
 
+		Future<GenericImage<rgb3>>
+		FilterRotate::filter_async( GenericImage<rgb3> image_input,
+		                            uint32_t const angle ) {
+			check_angle( angle );
+			return run_async( [image_input = std::move( image_input ), angle]( ) {
+				return filter( image_input, angle );
+			} );
+		}
+
+		OrientedView<rgb3>
+		FilterRotate::view( GenericImage<rgb3> const &image_input,
+		                    uint32_t const angle ) {
+			check_angle( angle );
+			return image_input.view( rotation( angle ) );
+		}
+
+		FilterRotate::file_methods
+		FilterRotate::filter_file( daw::string_view input_filename,
+		                           daw::string_view output_filename,
+		                           uint32_t const angle, bool const allow_exif ) {
+			check_angle( angle );
+			// The orientation a viewer applies to the stored pixels
+			auto current = orientation::identity;
+			if( FreeImage_GetFileType( input_filename.data( ) ) == FIF_JPEG ) {
+				auto jpeg = read_file( input_filename );
+				auto const tag = exif::find_orientation_tag( jpeg );
+				if( tag ) {
+					current = exif::read_orientation( jpeg, *tag );
+				}
+
+				// A lossless transform of pixels that a viewer already reorients
+				// would be applied in the wrong order, so leave those to the tag
+				if( current == orientation::identity &&
+				    FreeImage_JPEGTransform( input_filename.data( ),
+				                             output_filename.data( ),
+				                             jpeg_operation( angle ), TRUE ) ) {
+					return file_methods::lossless_jpeg;
+				}
+				if( allow_exif && tag ) {
+					exif::write_orientation( jpeg, *tag,
+					                         compose( current, rotation( angle ) ) );
+					write_file( output_filename, jpeg );
+					return file_methods::exif_orientation;
+				}
+			}
+			// The saved file has no Orientation tag, so bake the current one in
+			auto const image_input = from_file( input_filename );
+			GenericImage<rgb3>::to_file(
+			  output_filename,
+			  image_input.view( compose( current, rotation( angle ) ) ) );
+			return file_methods::reencode;
+		}
+
 #ifdef DAWFILTER_USEPYTHON
 		static void
 		register_python( std::string const nameoftype = "filter_rotate" ) {
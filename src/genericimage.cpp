@@ -20,18 +20,39 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #include <daw/daw_exception.h>
 #include <daw/daw_random.h>
 #include <daw/daw_string_view.h>
 
 #include "genericimage.h"
+#include "memoryaccounting.h"
+#include "parallelchunks.h"
+#include "scanline.h"
+#include "trace.h"
 
 namespace daw {
 	namespace imaging {
+		namespace {
+			// FreeImage allocates bitmaps itself, count them as well
+			size_t bitmap_size( FreeImage &bitmap ) {
+				return static_cast<size_t>( FreeImage_GetPitch( bitmap.ptr( ) ) ) *
+				       static_cast<size_t>( bitmap.height( ) );
+			}
+		} // namespace
+
 		void GenericImage<rgb3>::to_file( daw::string_view image_filename,
 		                                  GenericImage<rgb3> const &image_input ) {
+			to_file( image_filename, image_input.view( orientation::identity ) );
+		}
+
+		void GenericImage<rgb3>::to_file( daw::string_view image_filename,
+		                                  OrientedView<rgb3> const &image_input ) {
 			try {
 				daw::exception::daw_throw_on_false(
 				  image_input.width( ) <=
@@ -42,26 +63,102 @@ namespace daw {
 				FreeImage image_output(
 				  FreeImage_Allocate( static_cast<int>( image_input.width( ) ),
 				                      static_cast<int>( image_input.height( ) ), 24 ) );
-				{
-					daw::exception::daw_throw_on_false( image_input.height( ) > 0 );
+				memory::external_allocation const bitmap_bytes(
+				  bitmap_size( image_output ) );
+				if( image_input.size( ) > 0 ) {
+					DAW_TRACE_SPAN( "GenericImage::copy_to_bitmap" );
 					auto const maxy = image_input.height( ) - 1;
-					//#pragma omp parallel for
-					for( size_t y = 0; y < image_input.height( ); ++y ) {
-						RGBQUAD rgb_out;
-						for( size_t x = 0; x < image_input.width( ); ++x ) {
-							rgb3 const rgb_in = image_input( y, x );
-							rgb_out.rgbBlue = rgb_in.blue;
-							rgb_out.rgbGreen = rgb_in.green;
-							rgb_out.rgbRed = rgb_in.red;
-
-							if( !FreeImage_SetPixelColor(
-							      image_output.ptr( ), static_cast<unsigned>( x ),
-							      static_cast<unsigned>( maxy - y ), &rgb_out ) ) {
-								throw std::runtime_error( "Error setting pixel data" );
-							}
-						}
+					auto const band_rows = OrientedView<rgb3>::band_rows;
+					// FreeImage scanlines are bottom up.  Rows of an unrotated view are
+					// read in place, otherwise they are gathered a band at a time
+					impl::for_each_chunk(
+					  image_input.height( ),
+					  impl::chunk_count( image_input.height( ), band_rows ),
+					  [&]( size_t, size_t const first, size_t const last ) {
+						  image_vector<rgb3> band{};
+						  if( !image_input.is_identity( ) ) {
+							  band.resize( band_rows * image_input.width( ) );
+						  }
+						  for( size_t y0 = first; y0 < last; y0 += band_rows ) {
+							  auto const row_count = std::min( band_rows, last - y0 );
+							  if( !band.empty( ) ) {
+								  image_input.copy_rows( y0, row_count, band.data( ) );
+							  }
+							  for( size_t r = 0; r < row_count; ++r ) {
+								  auto const y = y0 + r;
+								  auto const *row =
+								    band.empty( ) ? image_input.source( ).row( y )
+								                  : band.data( ) + r * image_input.width( );
+								  impl::rgb3_to_scanline24(
+								    row,
+								    FreeImage_GetScanLine( image_output.ptr( ),
+								                           static_cast<int>( maxy - y ) ),
+								    image_input.width( ) );
+							  }
+						  }
+					  } );
+				}
+				DAW_TRACE_SPAN( "GenericImage::encode" );
+				auto fif = FreeImage_GetFIFFromFilename( image_filename.data( ) );
+				if( !FreeImage_Save( fif, image_output.ptr( ),
+				                     image_filename.data( ) ) ) {
+					auto const msg =
+					  "Error Saving image to file '" + image_filename.to_string( ) + "'";
+					throw std::runtime_error( msg );
+				}
+				image_output.close( );
+			} catch( std::runtime_error const & ) { throw; } catch( ... ) {
+				auto const msg =
+				  "An unknown exception has been thrown while saving image to file '" +
+				  image_filename.to_string( ) + "'";
+				throw std::runtime_error( msg );
+			}
+		}
+
+		template<>
+		void GenericImage<uint8_t>::to_file( daw::string_view image_filename,
+		                                     GenericImage<uint8_t> const &image_input ) {
+			try {
+				daw::exception::daw_throw_on_false(
+				  image_input.width( ) <=
+				  static_cast<size_t>( std::numeric_limits<int>::max( ) ) );
+				daw::exception::daw_throw_on_false(
+				  image_input.height( ) <=
+				  static_cast<size_t>( std::numeric_limits<int>::max( ) ) );
+				FreeImage image_output(
+				  FreeImage_Allocate( static_cast<int>( image_input.width( ) ),
+				                      static_cast<int>( image_input.height( ) ), 8 ) );
+				memory::external_allocation const bitmap_bytes(
+				  bitmap_size( image_output ) );
+				{
+					// A linear palette makes the bitmap FIC_MINISBLACK
+					auto *palette = FreeImage_GetPalette( image_output.ptr( ) );
+					daw::exception::daw_throw_on_null(
+					  palette, "Error allocating grayscale palette" );
+					for( unsigned n = 0; n < 256; ++n ) {
+						auto const level = static_cast<BYTE>( n );
+						palette[n].rgbRed = level;
+						palette[n].rgbGreen = level;
+						palette[n].rgbBlue = level;
+						palette[n].rgbReserved = 0;
 					}
 				}
+				if( image_input.size( ) > 0 ) {
+					DAW_TRACE_SPAN( "GenericImage::copy_to_bitmap" );
+					auto const maxy = image_input.height( ) - 1;
+					// FreeImage scanlines are bottom up
+					impl::for_each_chunk(
+					  image_input.height( ),
+					  impl::chunk_count( image_input.height( ), 16 ),
+					  [&]( size_t, size_t const first, size_t const last ) {
+						  for( size_t y = first; y < last; ++y ) {
+							  std::copy_n( &image_input( y, 0 ), image_input.width( ),
+							               FreeImage_GetScanLine(
+							                 image_output.ptr( ), static_cast<int>( maxy - y ) ) );
+						  }
+					  } );
+				}
+				DAW_TRACE_SPAN( "GenericImage::encode" );
 				auto fif = FreeImage_GetFIFFromFilename( image_filename.data( ) );
 				if( !FreeImage_Save( fif, image_output.ptr( ),
 				                     image_filename.data( ) ) ) {
@@ -78,8 +175,7 @@ namespace daw {
 			}
 		}
 
-		GenericImage<rgb3>
-		GenericImage<rgb3>::from_file( daw::string_view image_filename ) {
+		FreeImage load_bitmap( daw::string_view image_filename ) {
 			try {
 				{
 					boost::filesystem::path const pImageFile( image_filename.data( ) );
@@ -105,6 +201,7 @@ namespace daw {
 					}
 				}
 
+				DAW_TRACE_SPAN( "GenericImage::decode" );
 				std::string const input_image_msg =
 				  "Could not open input image '" + image_filename + '\'';
 				FreeImage image_input( FreeImage_Load( fif, image_filename.data( ) ),
@@ -128,34 +225,70 @@ namespace daw {
 					}
 					image_input.take( bitmap_test );
 				}
+				return image_input;
+			} catch( std::runtime_error const & ) { throw; } catch( ... ) {
+				auto const msg = "Unknown error while reading file'" +
+				                 image_filename.to_string( ) + "'";
+				throw std::runtime_error( msg );
+			}
+		}
+
+		ImageView<rgb3> make_view( FreeImage &bitmap ) {
+			if( bitmap.bpp( ) != 24 ) {
+				bitmap = FreeImage( FreeImage_ConvertTo24Bits( bitmap.ptr( ) ),
+				                    "Error converting image to 24bit RGB" );
+			}
+			if( !impl::rgb3_is_freeimage_order ) {
+				// The bitmap's bytes are not rgb3s, reorder them in place
+				auto const width = bitmap.width( );
+				auto const pitch = FreeImage_GetPitch( bitmap.ptr( ) );
+				auto *const bits = FreeImage_GetBits( bitmap.ptr( ) );
+				std::vector<rgb3> row( width );
+				for( size_t y = 0; y < bitmap.height( ); ++y ) {
+					auto *const line = bits + y * pitch;
+					impl::scanline24_to_rgb3( line, row.data( ), width );
+					std::memcpy( line, row.data( ), width * sizeof( rgb3 ) );
+				}
+			}
+			return ImageView<rgb3>(
+			  reinterpret_cast<rgb3 const *>( FreeImage_GetBits( bitmap.ptr( ) ) ),
+			  bitmap.width( ), bitmap.height( ), FreeImage_GetPitch( bitmap.ptr( ) ),
+			  true );
+		}
+
+		GenericImage<rgb3>
+		GenericImage<rgb3>::from_file( daw::string_view image_filename ) {
+			try {
+				auto image_input = load_bitmap( image_filename );
+				memory::external_allocation const bitmap_bytes(
+				  bitmap_size( image_input ) );
 				GenericImage<rgb3> image_output( image_input.width( ),
-				                                 image_input.height( ) );
+				                                 image_input.height( ), no_init );
 
-				{
-					daw::exception::daw_throw_on_false(
-					  image_output.width( ) <=
-					  static_cast<size_t>( std::numeric_limits<unsigned>::max( ) ) );
+				if( image_output.size( ) > 0 ) {
+					DAW_TRACE_SPAN( "GenericImage::copy_from_bitmap" );
 					daw::exception::daw_throw_on_false(
 					  image_output.height( ) <=
-					  static_cast<size_t>( std::numeric_limits<unsigned>::max( ) ) );
+					  static_cast<size_t>( std::numeric_limits<int>::max( ) ) );
 					auto const maxy = image_output.height( ) - 1;
+					auto const bytes_per_pixel = image_input.bpp( ) / 8;
 
-					for( size_t y = 0; y < image_output.height( ); ++y ) {
-						RGBQUAD rgb_in;
-						for( size_t x = 0; x < image_output.width( ); ++x ) {
-							if( FreeImage_GetPixelColor(
-							      image_input.ptr( ), static_cast<unsigned>( x ),
-							      static_cast<unsigned>( maxy - y ), &rgb_in ) ) {
-								rgb3 const rgb_out( rgb_in.rgbRed, rgb_in.rgbGreen,
-								                    rgb_in.rgbBlue );
-								image_output( y, x ) = rgb_out;
-							} else {
-								auto const msg = "Error retrieving pixel data from '" +
-								                 image_filename.to_string( ) + "'";
-								throw std::runtime_error( msg );
-							}
-						}
-					}
+					// FreeImage scanlines are bottom up
+					impl::for_each_chunk(
+					  image_output.height( ),
+					  impl::chunk_count( image_output.height( ), 16 ),
+					  [&]( size_t, size_t const first, size_t const last ) {
+						  for( size_t y = first; y < last; ++y ) {
+							  auto const *src = FreeImage_GetScanLine(
+							    image_input.ptr( ), static_cast<int>( maxy - y ) );
+							  auto *dst = &image_output( y, 0 );
+							  if( bytes_per_pixel == 3 ) {
+								  impl::scanline24_to_rgb3( src, dst, image_output.width( ) );
+							  } else {
+								  impl::scanline32_to_rgb3( src, dst, image_output.width( ) );
+							  }
+						  }
+					  } );
 				}
 				image_input.close( );
 				return image_output;
@@ -166,6 +299,83 @@ namespace daw {
 			}
 		}
 
+		GenericImage<rgb3>
+		GenericImage<rgb3>::from_view( ImageView<rgb3> const &image_view ) {
+			GenericImage<rgb3> image_output( image_view.width( ),
+			                                 image_view.height( ), no_init );
+			if( image_output.size( ) > 0 ) {
+				impl::for_each_chunk(
+				  image_output.height( ),
+				  impl::chunk_count( image_output.height( ), 16 ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  for( size_t y = first; y < last; ++y ) {
+						  std::copy_n( image_view.row( y ), image_output.width( ),
+						               &image_output( y, 0 ) );
+					  }
+				  } );
+			}
+			return image_output;
+		}
+
+		GenericImage<rgb3>
+		GenericImage<rgb3>::from_view( OrientedView<rgb3> const &image_view ) {
+			GenericImage<rgb3> image_output( image_view.width( ),
+			                                 image_view.height( ), no_init );
+			if( image_output.size( ) > 0 ) {
+				impl::for_each_chunk(
+				  image_output.height( ),
+				  impl::chunk_count( image_output.height( ),
+				                     OrientedView<rgb3>::band_rows ),
+				  [&]( size_t, size_t const first, size_t const last ) {
+					  auto const band_rows = OrientedView<rgb3>::band_rows;
+					  for( size_t y = first; y < last; y += band_rows ) {
+						  image_view.copy_rows( y, std::min( band_rows, last - y ),
+						                        image_output.row( y ),
+						                        image_output.stride( ) );
+					  }
+				  } );
+			}
+			return image_output;
+		}
+
+		PlanarImage<uint8_t> to_planar( GenericImage<rgb3> const &image_input ) {
+			PlanarImage<uint8_t> image_output( image_input.width( ),
+			                                   image_input.height( ), no_init );
+			auto const width = image_input.width( );
+			impl::for_each_chunk(
+			  image_input.height( ), impl::chunk_count( image_input.height( ), 16 ),
+			  [&]( size_t, size_t const first, size_t const last ) {
+				  for( size_t y = first; y < last; ++y ) {
+					  auto const *const src = image_input.row( y );
+					  auto *const red = image_output.red( ) + y * width;
+					  auto *const green = image_output.green( ) + y * width;
+					  auto *const blue = image_output.blue( ) + y * width;
+					  for( size_t x = 0; x < width; ++x ) {
+						  red[x] = src[x].red;
+						  green[x] = src[x].green;
+						  blue[x] = src[x].blue;
+					  }
+				  }
+			  } );
+			return image_output;
+		}
+
+		GenericImage<rgb3> to_packed( PlanarImage<uint8_t> const &image_input ) {
+			GenericImage<rgb3> image_output( image_input.width( ),
+			                                 image_input.height( ), no_init );
+			impl::for_each_chunk(
+			  image_input.size( ), impl::chunk_count( image_input.size( ), 1U << 16U ),
+			  [&]( size_t, size_t const first, size_t const last ) {
+				  auto const *const red = image_input.red( );
+				  auto const *const green = image_input.green( );
+				  auto const *const blue = image_input.blue( );
+				  for( size_t n = first; n < last; ++n ) {
+					  image_output[n] = rgb3( red[n], green[n], blue[n] );
+				  }
+			  } );
+			return image_output;
+		}
+
 #ifdef DAWFILTER_USEPYTHON
 		void GenericImage<rgb3>::register_python( std::string const &nameoftype ) {
 			boost::python::class_<GenericImage<rgb3>>(
@@ -0,0 +1,150 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <new>
+
+#include "imagebuffer.h"
+#include "imagepool.h"
+#include "memoryaccounting.h"
+
+namespace daw {
+	namespace imaging {
+		namespace {
+			constexpr size_t min_size_class = 256;
+
+			std::atomic<std::pmr::memory_resource *> &image_memory_resource( ) {
+				static std::atomic<std::pmr::memory_resource *> s_resource{
+				  memory::counting_resource( )};
+				return s_resource;
+			}
+		} // namespace
+
+		ImagePool::ImagePool( size_t max_cached_bytes,
+		                      std::pmr::memory_resource *upstream )
+		  : m_upstream{upstream}
+		  , m_max_cached_bytes{max_cached_bytes}
+		  , m_mutex{}
+		  , m_free_lists{}
+		  , m_cached_bytes{0}
+		  , m_hits{0}
+		  , m_misses{0} {}
+
+		ImagePool::~ImagePool( ) {
+			release( );
+		}
+
+		size_t ImagePool::size_class( size_t bytes ) noexcept {
+			if( bytes <= min_size_class ) {
+				return min_size_class;
+			}
+			// Split each power of two into 4 classes
+			size_t high_bit = 1;
+			while( high_bit <= ( bytes - 1 ) / 2 ) {
+				high_bit *= 2;
+			}
+			auto const step = high_bit / 4;
+			return ( ( bytes + step - 1 ) / step ) * step;
+		}
+
+		void *ImagePool::do_allocate( size_t bytes, size_t alignment ) {
+			if( alignment > cache_line_size ) {
+				return m_upstream->allocate( bytes, alignment );
+			}
+			auto const class_bytes = size_class( bytes );
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				auto pos = m_free_lists.find( class_bytes );
+				if( pos != m_free_lists.end( ) && !pos->second.empty( ) ) {
+					auto *result = pos->second.back( );
+					pos->second.pop_back( );
+					m_cached_bytes -= class_bytes;
+					m_hits.fetch_add( 1, std::memory_order_relaxed );
+					return result;
+				}
+			}
+			m_misses.fetch_add( 1, std::memory_order_relaxed );
+			return m_upstream->allocate( class_bytes, cache_line_size );
+		}
+
+		void ImagePool::do_deallocate( void *p, size_t bytes, size_t alignment ) {
+			if( alignment > cache_line_size ) {
+				m_upstream->deallocate( p, bytes, alignment );
+				return;
+			}
+			auto const class_bytes = size_class( bytes );
+			{
+				std::lock_guard<std::mutex> lock( m_mutex );
+				if( m_cached_bytes + class_bytes <= m_max_cached_bytes ) {
+					// Caching can allocate, freeing must not throw, so give the buffer
+					// back instead when that fails
+					try {
+						m_free_lists[class_bytes].push_back( p );
+						m_cached_bytes += class_bytes;
+						return;
+					} catch( std::bad_alloc const & ) {}
+				}
+			}
+			m_upstream->deallocate( p, class_bytes, cache_line_size );
+		}
+
+		bool ImagePool::do_is_equal( std::pmr::memory_resource const &other ) const
+		  noexcept {
+			return this == &other;
+		}
+
+		ImagePool::statistics ImagePool::stats( ) const {
+			std::lock_guard<std::mutex> lock( m_mutex );
+			return statistics{m_hits.load( std::memory_order_relaxed ),
+			                  m_misses.load( std::memory_order_relaxed ),
+			                  m_cached_bytes};
+		}
+
+		void ImagePool::release( ) {
+			std::lock_guard<std::mutex> lock( m_mutex );
+			for( auto &free_list : m_free_lists ) {
+				for( auto *p : free_list.second ) {
+					m_upstream->deallocate( p, free_list.first, cache_line_size );
+				}
+			}
+			m_free_lists.clear( );
+			m_cached_bytes = 0;
+		}
+
+		ImagePool &default_image_pool( ) {
+			// Created after the counting resource, so destroyed before it
+			static ImagePool s_pool{ImagePool::default_max_cached_bytes,
+			                        memory::counting_resource( )};
+			return s_pool;
+		}
+
+		std::pmr::memory_resource *get_image_memory_resource( ) noexcept {
+			return image_memory_resource( ).load( std::memory_order_acquire );
+		}
+
+		void set_image_memory_resource( std::pmr::memory_resource *resource ) noexcept {
+			image_memory_resource( ).store(
+			  resource != nullptr ? resource : memory::counting_resource( ),
+			  std::memory_order_release );
+		}
+	} // namespace imaging
+} // namespace daw
@@ -0,0 +1,158 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "memoryaccounting.h"
+
+namespace daw {
+	namespace imaging {
+		namespace memory {
+			namespace {
+				account_ptr &current_account_storage( ) noexcept {
+					thread_local account_ptr current{};
+					return current;
+				}
+
+				// Puts the account an allocation was made in ahead of the block, so
+				// freeing it is counted there whoever frees it
+				class counting_memory_resource : public std::pmr::memory_resource {
+					static size_t header_size( size_t const alignment ) noexcept {
+						return std::max( alignment, sizeof( account_ptr ) );
+					}
+
+					static account_ptr *header( void *const p ) noexcept {
+						return static_cast<account_ptr *>( p ) - 1;
+					}
+
+					void *do_allocate( size_t bytes, size_t alignment ) override {
+						alignment = std::max( alignment, alignof( account_ptr ) );
+						auto const offset = header_size( alignment );
+						auto *const block = static_cast<char *>(
+						  std::pmr::new_delete_resource( )->allocate( bytes + offset,
+						                                              alignment ) );
+						auto *const result = block + offset;
+						auto const &owner = current_account( );
+						new( header( result ) ) account_ptr( owner );
+						if( owner ) {
+							owner->add_allocation( bytes );
+						}
+						return result;
+					}
+
+					void do_deallocate( void *p, size_t bytes,
+					                    size_t alignment ) override {
+						alignment = std::max( alignment, alignof( account_ptr ) );
+						auto const offset = header_size( alignment );
+						auto *const owner = header( p );
+						if( *owner ) {
+							( *owner )->add_deallocation( bytes );
+						}
+						owner->~account_ptr( );
+						std::pmr::new_delete_resource( )->deallocate(
+						  static_cast<char *>( p ) - offset, bytes + offset, alignment );
+					}
+
+					bool do_is_equal(
+					  std::pmr::memory_resource const &other ) const noexcept override {
+						return this == &other;
+					}
+				};
+			} // namespace
+
+			account::account( std::shared_ptr<account> parent ) noexcept
+			  : m_parent( std::move( parent ) ) {}
+
+			usage account::get_usage( ) const noexcept {
+				return usage{m_current.load( ), m_peak.load( ), m_allocated.load( ),
+				             m_allocations.load( )};
+			}
+
+			void account::add_allocation( size_t const bytes ) noexcept {
+				auto const amount = static_cast<int64_t>( bytes );
+				for( auto *a = this; a != nullptr; a = a->m_parent.get( ) ) {
+					auto const current =
+					  a->m_current.fetch_add( amount, std::memory_order_relaxed ) +
+					  amount;
+					auto peak = a->m_peak.load( std::memory_order_relaxed );
+					while( current > peak &&
+					       !a->m_peak.compare_exchange_weak(
+					         peak, current, std::memory_order_relaxed ) ) {
+					}
+					a->m_allocated.fetch_add( bytes, std::memory_order_relaxed );
+					a->m_allocations.fetch_add( 1, std::memory_order_relaxed );
+				}
+			}
+
+			void account::add_deallocation( size_t const bytes ) noexcept {
+				auto const amount = static_cast<int64_t>( bytes );
+				for( auto *a = this; a != nullptr; a = a->m_parent.get( ) ) {
+					a->m_current.fetch_sub( amount, std::memory_order_relaxed );
+				}
+			}
+
+			account_ptr const &current_account( ) noexcept {
+				return current_account_storage( );
+			}
+
+			scope::scope( )
+			  : m_account( std::make_shared<account>( current_account( ) ) )
+			  , m_previous( current_account( ) ) {
+				current_account_storage( ) = m_account;
+			}
+
+			scope::~scope( ) {
+				current_account_storage( ) = std::move( m_previous );
+			}
+
+			scope_binding::scope_binding( account_ptr current ) noexcept
+			  : m_previous( std::move( current ) ) {
+				std::swap( m_previous, current_account_storage( ) );
+			}
+
+			scope_binding::~scope_binding( ) {
+				current_account_storage( ) = std::move( m_previous );
+			}
+
+			std::pmr::memory_resource *counting_resource( ) noexcept {
+				static counting_memory_resource resource{};
+				return &resource;
+			}
+
+			external_allocation::external_allocation( size_t const bytes ) noexcept
+			  : m_account( current_account( ) )
+			  , m_bytes( bytes ) {
+				if( m_account ) {
+					m_account->add_allocation( m_bytes );
+				}
+			}
+
+			external_allocation::~external_allocation( ) {
+				if( m_account ) {
+					m_account->add_deallocation( m_bytes );
+				}
+			}
+		} // namespace memory
+	}   // namespace imaging
+} // namespace daw
@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "netpbm.h"
+
+namespace daw {
+	namespace imaging {
+		namespace {
+			static_assert( sizeof( rgb3 ) == 3,
+			               "rgb3 must be packed to read rows in place" );
+
+			void skip_whitespace_and_comments( std::istream &is ) {
+				while( is ) {
+					auto const c = is.peek( );
+					if( c == std::char_traits<char>::eof( ) ) {
+						return;
+					} else if( c == '#' ) {
+						is.ignore( std::numeric_limits<std::streamsize>::max( ), '\n' );
+					} else if( std::isspace( c ) ) {
+						is.get( );
+					} else {
+						return;
+					}
+				}
+			}
+
+			size_t read_header_value( std::istream &is,
+			                          std::string const &filename ) {
+				skip_whitespace_and_comments( is );
+				size_t result = 0;
+				if( !( is >> result ) ) {
+					auto const msg = "Invalid netpbm header in '" + filename + "'";
+					throw std::runtime_error( msg );
+				}
+				return result;
+			}
+		} // namespace
+
+		NetpbmReader::NetpbmReader( daw::string_view filename )
+		  : m_filename{filename.to_string( )}
+		  , m_file{m_filename, std::ios::binary}
+		  , m_width{0}
+		  , m_height{0}
+		  , m_data_offset{0} {
+
+			if( !m_file ) {
+				auto const msg = "Could not open input image '" + m_filename + "'";
+				throw std::runtime_error( msg );
+			}
+			char magic[2] = {0, 0};
+			m_file.read( magic, 2 );
+			if( magic[0] != 'P' || magic[1] != '6' ) {
+				auto const msg =
+				  "'" + m_filename + "' is not a binary RGB netpbm (P6) file";
+				throw std::runtime_error( msg );
+			}
+			m_width = read_header_value( m_file, m_filename );
+			m_height = read_header_value( m_file, m_filename );
+			if( read_header_value( m_file, m_filename ) != 255 ) {
+				auto const msg = "'" + m_filename + "' is not an 8bit netpbm file";
+				throw std::runtime_error( msg );
+			}
+			// A single whitespace character separates the header from the data
+			m_file.get( );
+			m_data_offset = static_cast<std::streamoff>( m_file.tellg( ) );
+		}
+
+		void NetpbmReader::read_rows( size_t const first_row,
+		                              size_t const row_count, rgb3 *rows ) {
+			daw::exception::daw_throw_on_false( first_row + row_count <= m_height,
+			                                    "Attempt to read past last row" );
+			auto const row_bytes = m_width * sizeof( rgb3 );
+			m_file.seekg( m_data_offset +
+			              static_cast<std::streamoff>( first_row * row_bytes ) );
+			auto const pixel_count = row_count * m_width;
+			if( !m_file.read( reinterpret_cast<char *>( rows ),
+			                  static_cast<std::streamsize>( pixel_count *
+			                                                sizeof( rgb3 ) ) ) ) {
+				auto const msg = "Error retrieving pixel data from '" + m_filename + "'";
+				throw std::runtime_error( msg );
+			}
+			// netpbm stores red first, rgb3 stores blue first
+			for( size_t n = 0; n < pixel_count; ++n ) {
+				std::swap( rows[n].red, rows[n].blue );
+			}
+		}
+
+		NetpbmWriter::NetpbmWriter( daw::string_view filename,
+		                            size_t const width, size_t const height )
+		  : m_filename{filename.to_string( )}
+		  , m_file{m_filename, std::ios::binary | std::ios::trunc}
+		  , m_width{width}
+		  , m_height{height}
+		  , m_data_offset{0} {
+
+			if( !m_file ) {
+				auto const msg = "Error Saving image to file '" + m_filename + "'";
+				throw std::runtime_error( msg );
+			}
+			m_file << "P5\n" << m_width << ' ' << m_height << "\n255\n";
+			m_data_offset = static_cast<std::streamoff>( m_file.tellp( ) );
+		}
+
+		void NetpbmWriter::write_rows( size_t const first_row,
+		                               size_t const row_count,
+		                               uint8_t const *levels ) {
+			daw::exception::daw_throw_on_false( first_row + row_count <= m_height,
+			                                    "Attempt to write past last row" );
+			m_file.seekp( m_data_offset +
+			              static_cast<std::streamoff>( first_row * m_width ) );
+			if( !m_file.write( reinterpret_cast<char const *>( levels ),
+			                   static_cast<std::streamsize>( row_count * m_width ) ) ) {
+				auto const msg = "Error Saving image to file '" + m_filename + "'";
+				throw std::runtime_error( msg );
+			}
+		}
+
+		void NetpbmWriter::close( ) {
+			m_file.flush( );
+			auto const flushed = m_file.good( );
+			m_file.close( );
+			if( !flushed || m_file.fail( ) ) {
+				auto const msg = "Error Saving image to file '" + m_filename + "'";
+				throw std::runtime_error( msg );
+			}
+		}
+	} // namespace imaging
+} // namespace daw
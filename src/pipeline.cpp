@@ -0,0 +1,378 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <daw/daw_exception.h>
+
+#include "dawgs2lut.h"
+#include "dawgsbinmap.h"
+#include "dawgskeyset.h"
+#include "filterdawgs.h"
+#include "imagebuffer.h"
+#include "parallelchunks.h"
+#include "pipeline.h"
+#include "repaintkernels.h"
+
+namespace daw {
+	namespace imaging {
+		namespace {
+			class dawgs_reduction final : public Pipeline::Reduction {
+				std::vector<DAWGSKeySet> m_partials;
+
+			public:
+				void begin( size_t const chunks ) override {
+					m_partials = std::vector<DAWGSKeySet>( chunks );
+				}
+
+				void accumulate( size_t const chunk,
+				                 Pipeline::band const &pixels ) override {
+					auto &keys = m_partials[chunk];
+					for( size_t n = 0; n < pixels.size( ); ++n ) {
+						keys.insert( FilterDAWGS::too_gs( pixels.pixels[n] ) );
+					}
+				}
+
+				Pipeline::map_t finish( ) override {
+					auto const keys = DAWGSKeySet::merge( std::move( m_partials ) );
+					m_partials.clear( );
+					if( keys.size( ) <= 256 ) {
+						return []( Pipeline::band const &pixels ) {
+							std::transform( pixels.pixels, pixels.pixels + pixels.size( ),
+							                pixels.pixels, []( rgb3 const &rgb ) {
+								                return rgb3( static_cast<uint8_t>(
+								                  rgb.too_float_gs( ) ) );
+							                } );
+						};
+					}
+					auto const bin_map = DAWGSBinMap::from_keys( keys );
+					return [bin_map]( Pipeline::band const &pixels ) {
+						bin_map.map( pixels.pixels, pixels.pixels + pixels.size( ),
+						             pixels.pixels, []( rgb3 const &rgb ) {
+							             return FilterDAWGS::too_gs( rgb );
+						             } );
+					};
+				}
+			};
+
+			class dawgs2_reduction final : public Pipeline::Reduction {
+				image_vector<DAWGS2Sums> m_partials;
+				size_t m_size;
+
+			public:
+				explicit dawgs2_reduction( size_t const size )
+				  : m_partials{}
+				  , m_size{size} {}
+
+				void begin( size_t const chunks ) override {
+					m_partials = image_vector<DAWGS2Sums>( chunks );
+				}
+
+				void accumulate( size_t const chunk,
+				                 Pipeline::band const &pixels ) override {
+					for( size_t r = 0; r < pixels.row_count; ++r ) {
+						m_partials[chunk].add( pixels.pixels + r * pixels.width,
+						                       pixels.width );
+					}
+				}
+
+				Pipeline::map_t finish( ) override {
+					DAWGS2Sums sums{};
+					for( auto const &partial : m_partials ) {
+						sums += partial;
+					}
+					auto const lut = DAWGS2LUT::from_sums( sums, m_size );
+					return [lut]( Pipeline::band const &pixels ) {
+						for( size_t n = 0; n < pixels.size( ); ++n ) {
+							pixels.pixels[n] = rgb3( lut( pixels.pixels[n] ) );
+						}
+					};
+				}
+			};
+
+			template<typename Formula>
+			class colourize_reduction final : public Pipeline::Reduction {
+				GenericImage<uint8_t> const *m_gsimage;
+				image_vector<impl::repaint_range> m_partials;
+
+				// Call func( x, count, result ) for each block of repainted pixels
+				// of the band
+				template<typename Func>
+				void for_each_repaint_block( Pipeline::band const &pixels,
+				                             Func func ) const {
+					Formula const repaint{};
+					impl::repaint_block block;
+					impl::repaint_result result;
+					for( size_t r = 0; r < pixels.row_count; ++r ) {
+						auto *const orig = pixels.pixels + r * pixels.width;
+						auto const *const gs = m_gsimage->row( pixels.first_row + r );
+						for( size_t x = 0; x < pixels.width; x += impl::repaint_lanes ) {
+							auto const count =
+							  std::min( impl::repaint_lanes, pixels.width - x );
+							impl::load_repaint_block( orig + x, gs + x, count, block );
+							repaint( block, result );
+							func( orig + x, count, result );
+						}
+					}
+				}
+
+			public:
+				explicit colourize_reduction( GenericImage<uint8_t> const &gsimage )
+				  : m_gsimage{&gsimage}
+				  , m_partials{} {}
+
+				void begin( size_t const chunks ) override {
+					m_partials = image_vector<impl::repaint_range>( chunks );
+				}
+
+				void accumulate( size_t const chunk,
+				                 Pipeline::band const &pixels ) override {
+					auto &partial = m_partials[chunk];
+					for_each_repaint_block(
+					  pixels, [&partial]( rgb3 *, size_t const count,
+					                      impl::repaint_result const &result ) {
+						  partial.add( result, count );
+					  } );
+				}
+
+				Pipeline::map_t finish( ) override {
+					impl::repaint_range range{};
+					for( auto const &partial : m_partials ) {
+						range.merge( partial );
+					}
+					auto const scale = range.scale( );
+					// The block is loaded before its pixels are overwritten, so the
+					// band is normalised in place
+					return [this, range, scale]( Pipeline::band const &pixels ) {
+						for_each_repaint_block(
+						  pixels, [&]( rgb3 *const out, size_t const count,
+						               impl::repaint_result const &result ) {
+							  impl::normalise_repaint( result, count, range, scale, out );
+						  } );
+					};
+				}
+			};
+
+			std::shared_ptr<Pipeline::Reduction> make_colourize_reduction(
+			  GenericImage<uint8_t> const &input_gsimage,
+			  FilterDAWGSColourize::repaint_formulas const repaint_formula ) {
+				switch( repaint_formula ) {
+				case FilterDAWGSColourize::repaint_formulas::Ratio:
+					return std::make_shared<colourize_reduction<repaint::ratio>>(
+					  input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::YUV:
+					return std::make_shared<colourize_reduction<repaint::yuv>>(
+					  input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::Multiply_1:
+					return std::make_shared<colourize_reduction<repaint::multiply_1>>(
+					  input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::Addition:
+					return std::make_shared<colourize_reduction<repaint::addition>>(
+					  input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::Multiply_2:
+					return std::make_shared<colourize_reduction<repaint::multiply_2>>(
+					  input_gsimage );
+				case FilterDAWGSColourize::repaint_formulas::HSL:
+					return std::make_shared<colourize_reduction<repaint::hsl>>(
+					  input_gsimage );
+				}
+				throw std::runtime_error( "Unknown repaint formula" );
+			}
+		} // namespace
+
+		Pipeline::Reduction::~Reduction( ) = default;
+
+		Pipeline::Pipeline( OrientedView<rgb3> const &source,
+		                    size_t const band_bytes )
+		  : m_source{source}
+		  , m_stages{}
+		  , m_band_bytes{band_bytes} {}
+
+		Pipeline::Pipeline( ImageView<rgb3> const &source,
+		                    size_t const band_bytes )
+		  : Pipeline( OrientedView<rgb3>( source ), band_bytes ) {}
+
+		size_t Pipeline::band_rows( ) const noexcept {
+			auto const row_bytes = std::max( width( ), static_cast<size_t>( 1 ) ) *
+			                       sizeof( rgb3 );
+			return std::max( m_band_bytes / row_bytes, static_cast<size_t>( 1 ) );
+		}
+
+		size_t Pipeline::band_count( ) const noexcept {
+			return ( height( ) + band_rows( ) - 1 ) / band_rows( );
+		}
+
+		size_t Pipeline::chunk_count( ) const noexcept {
+			return impl::chunk_count( band_count( ), 1 );
+		}
+
+		size_t Pipeline::pass_count( ) const noexcept {
+			return 1 + static_cast<size_t>( std::count_if(
+			             m_stages.begin( ), m_stages.end( ),
+			             []( stage const &s ) { return s.reduction != nullptr; } ) );
+		}
+
+		Pipeline &Pipeline::orient( orientation const o ) {
+			daw::exception::daw_throw_on_false(
+			  m_stages.empty( ),
+			  "Pipeline orientation must be set before any other stage" );
+			m_source = m_source.then( o );
+			return *this;
+		}
+
+		Pipeline &Pipeline::rotate( uint32_t const angle ) {
+			daw::exception::daw_throw_on_false(
+			  angle <= 3, "Cannot specify an angle other than 0 to 3 inclusive" );
+			return orient( rotation( angle ) );
+		}
+
+		Pipeline &Pipeline::map( map_t stage_map ) {
+			m_stages.push_back( stage{std::move( stage_map ), nullptr} );
+			return *this;
+		}
+
+		Pipeline &Pipeline::reduce( std::shared_ptr<Reduction> reduction ) {
+			daw::exception::daw_throw_on_null( reduction.get( ),
+			                                   "Pipeline reduction is null" );
+			m_stages.push_back( stage{nullptr, std::move( reduction )} );
+			return *this;
+		}
+
+		Pipeline &Pipeline::dawgs( ) {
+			return reduce( std::make_shared<dawgs_reduction>( ) );
+		}
+
+		Pipeline &Pipeline::dawgs2( ) {
+			return reduce( std::make_shared<dawgs2_reduction>( m_source.size( ) ) );
+		}
+
+		Pipeline &Pipeline::colourize(
+		  GenericImage<uint8_t> const &input_gsimage,
+		  FilterDAWGSColourize::repaint_formulas const repaint_formula ) {
+			if( input_gsimage.width( ) != width( ) ||
+			    input_gsimage.height( ) != height( ) ) {
+				throw std::runtime_error(
+				  "Pipeline::colourize grayscale image size does not match the "
+				  "pipeline" );
+			}
+			return reduce(
+			  make_colourize_reduction( input_gsimage, repaint_formula ) );
+		}
+
+		void Pipeline::run_pass(
+		  std::vector<map_t> const &maps,
+		  std::function<void( size_t chunk, band const & )> const &consume,
+		  rgb3 *const output ) const {
+			auto const rows = band_rows( );
+			impl::for_each_chunk(
+			  band_count( ), chunk_count( ),
+			  [&]( size_t const chunk, size_t const first, size_t const last ) {
+				  image_vector<rgb3> buffer{};
+				  if( output == nullptr ) {
+					  buffer.resize( rows * width( ) );
+				  }
+				  for( size_t n = first; n < last; ++n ) {
+					  auto const first_row = n * rows;
+					  band const pixels{
+					    first_row, std::min( rows, height( ) - first_row ), width( ),
+					    output != nullptr ? output + first_row * width( )
+					                      : buffer.data( )};
+					  m_source.copy_rows( pixels.first_row, pixels.row_count,
+					                      pixels.pixels );
+					  for( auto const &stage_map : maps ) {
+						  stage_map( pixels );
+					  }
+					  consume( chunk, pixels );
+				  }
+			  } );
+		}
+
+		std::vector<Pipeline::map_t> Pipeline::resolve( ) {
+			std::vector<map_t> maps{};
+			maps.reserve( m_stages.size( ) );
+			for( auto const &s : m_stages ) {
+				if( s.reduction == nullptr ) {
+					maps.push_back( s.map );
+					continue;
+				}
+				s.reduction->begin( chunk_count( ) );
+				run_pass( maps,
+				          [&s]( size_t const chunk, band const &pixels ) {
+					          s.reduction->accumulate( chunk, pixels );
+				          },
+				          nullptr );
+				maps.push_back( s.reduction->finish( ) );
+			}
+			return maps;
+		}
+
+		GenericImage<rgb3> Pipeline::run( ) {
+			auto const maps = resolve( );
+			GenericImage<rgb3> image_output( width( ), height( ), no_init );
+			if( image_output.size( ) == 0 ) {
+				return image_output;
+			}
+			// Unpadded output is used as the band memory, otherwise bands are
+			// copied to their rows
+			if( image_output.is_contiguous( ) ) {
+				run_pass( maps, []( size_t, band const & ) {}, image_output.row( 0 ) );
+				return image_output;
+			}
+			run_pass( maps,
+			          [&image_output]( size_t, band const &pixels ) {
+				          for( size_t r = 0; r < pixels.row_count; ++r ) {
+					          std::copy_n( pixels.pixels + r * pixels.width, pixels.width,
+					                       image_output.row( pixels.first_row + r ) );
+				          }
+			          },
+			          nullptr );
+			return image_output;
+		}
+
+		GenericImage<uint8_t> Pipeline::run_gs( ) {
+			auto const maps = resolve( );
+			GenericImage<uint8_t> image_output( width( ), height( ), no_init );
+			if( image_output.size( ) == 0 ) {
+				return image_output;
+			}
+			run_pass( maps,
+			          [&image_output]( size_t, band const &pixels ) {
+				          for( size_t r = 0; r < pixels.row_count; ++r ) {
+					          auto const *const in = pixels.pixels + r * pixels.width;
+					          auto *const out = image_output.row( pixels.first_row + r );
+					          for( size_t x = 0; x < pixels.width; ++x ) {
+						          out[x] = in[x].red;
+					          }
+				          }
+			          },
+			          nullptr );
+			return image_output;
+		}
+
+		void Pipeline::to_file( daw::string_view image_filename ) {
+			run( ).to_file( image_filename );
+		}
+	} // namespace imaging
+} // namespace daw
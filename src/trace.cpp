@@ -0,0 +1,232 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+#include "trace.h"
+
+namespace daw {
+	namespace imaging {
+		namespace trace {
+#ifdef DAWFILTER_TRACING
+			namespace {
+				// Events of one thread.  Only the owning thread appends, publishing
+				// each event with a release store of the block's count, so recording
+				// never takes a lock.  Readers walk the blocks with acquire loads
+				struct event_block {
+					static constexpr size_t capacity = 4096;
+					std::array<event, capacity> events;
+					std::atomic<size_t> count{0};
+					std::atomic<event_block *> next{nullptr};
+				};
+
+				class thread_buffer {
+					event_block m_first{};
+					event_block *m_last = &m_first;
+					uint32_t m_thread_id;
+
+				public:
+					explicit thread_buffer( uint32_t const thread_id ) noexcept
+					  : m_thread_id( thread_id ) {}
+
+					~thread_buffer( ) {
+						free_blocks( );
+					}
+
+					thread_buffer( thread_buffer const & ) = delete;
+					thread_buffer &operator=( thread_buffer const & ) = delete;
+
+					void append( char const *name, uint64_t const start_ns,
+					             uint64_t const end_ns ) noexcept {
+						auto count = m_last->count.load( std::memory_order_relaxed );
+						if( count == event_block::capacity ) {
+							// Drop the event rather than throw from a destructor
+							auto *const block = new( std::nothrow ) event_block{};
+							if( block == nullptr ) {
+								return;
+							}
+							m_last->next.store( block, std::memory_order_release );
+							m_last = block;
+							count = 0;
+						}
+						m_last->events[count] =
+						  event{name, start_ns, end_ns - start_ns, m_thread_id};
+						m_last->count.store( count + 1, std::memory_order_release );
+					}
+
+					void collect( std::vector<event> &out ) const {
+						for( auto const *block = &m_first; block != nullptr;
+						     block = block->next.load( std::memory_order_acquire ) ) {
+							auto const count =
+							  block->count.load( std::memory_order_acquire );
+							out.insert( out.end( ), block->events.begin( ),
+							            block->events.begin( ) + count );
+						}
+					}
+
+					void clear( ) noexcept {
+						free_blocks( );
+						m_first.count.store( 0, std::memory_order_release );
+						m_last = &m_first;
+					}
+
+				private:
+					void free_blocks( ) noexcept {
+						auto *block = m_first.next.exchange( nullptr );
+						while( block != nullptr ) {
+							auto *const next = block->next.load( );
+							delete block;
+							block = next;
+						}
+					}
+				};
+
+				// Buffers outlive their threads so spans of finished threads can
+				// still be exported
+				struct registry {
+					std::mutex mutex;
+					std::vector<std::shared_ptr<thread_buffer>> buffers;
+				};
+
+				registry &get_registry( ) {
+					static registry reg{};
+					return reg;
+				}
+
+				thread_buffer *local_buffer( ) noexcept {
+					thread_local std::shared_ptr<thread_buffer> const buffer =
+					  []( ) -> std::shared_ptr<thread_buffer> {
+						try {
+							auto &reg = get_registry( );
+							std::lock_guard<std::mutex> lock( reg.mutex );
+							auto result = std::make_shared<thread_buffer>(
+							  static_cast<uint32_t>( reg.buffers.size( ) ) );
+							reg.buffers.push_back( result );
+							return result;
+						} catch( ... ) { return nullptr; }
+					}( );
+					return buffer.get( );
+				}
+
+				std::chrono::steady_clock::time_point origin( ) noexcept {
+					static auto const start = std::chrono::steady_clock::now( );
+					return start;
+				}
+			} // namespace
+
+			namespace impl {
+				uint64_t now_ns( ) noexcept {
+					auto const start = origin( );
+					return static_cast<uint64_t>(
+					  std::chrono::duration_cast<std::chrono::nanoseconds>(
+					    std::chrono::steady_clock::now( ) - start )
+					    .count( ) );
+				}
+
+				void record( char const *name, uint64_t const start_ns ) noexcept {
+					auto const end_ns = now_ns( );
+					if( auto *const buffer = local_buffer( ); buffer != nullptr ) {
+						buffer->append( name, start_ns, end_ns );
+					}
+				}
+			} // namespace impl
+
+			std::vector<event> events( ) {
+				std::vector<event> result{};
+				{
+					auto &reg = get_registry( );
+					std::lock_guard<std::mutex> lock( reg.mutex );
+					for( auto const &buffer : reg.buffers ) {
+						buffer->collect( result );
+					}
+				}
+				std::sort( result.begin( ), result.end( ),
+				           []( event const &lhs, event const &rhs ) {
+					           return lhs.start_ns < rhs.start_ns;
+				           } );
+				return result;
+			}
+
+			void clear( ) {
+				auto &reg = get_registry( );
+				std::lock_guard<std::mutex> lock( reg.mutex );
+				for( auto const &buffer : reg.buffers ) {
+					buffer->clear( );
+				}
+			}
+#else
+			std::vector<event> events( ) {
+				return {};
+			}
+
+			void clear( ) {}
+#endif
+
+			namespace {
+				void write_json_string( std::ostream &out, char const *str ) {
+					out << '"';
+					for( ; *str != '\0'; ++str ) {
+						if( *str == '"' || *str == '\\' ) {
+							out << '\\';
+						}
+						out << *str;
+					}
+					out << '"';
+				}
+			} // namespace
+
+			void write_chrome_trace( std::ostream &out ) {
+				auto const all_events = events( );
+				// Chrome wants microseconds
+				out << "{\"traceEvents\":[" << std::fixed << std::setprecision( 3 );
+				for( size_t n = 0; n < all_events.size( ); ++n ) {
+					auto const &e = all_events[n];
+					out << ( n == 0 ? "\n" : ",\n" ) << "{\"name\":";
+					write_json_string( out, e.name );
+					out << ",\"cat\":\"dawfilter\",\"ph\":\"X\",\"ts\":"
+					    << static_cast<double>( e.start_ns ) / 1000.0
+					    << ",\"dur\":" << static_cast<double>( e.duration_ns ) / 1000.0
+					    << ",\"pid\":1,\"tid\":" << e.thread_id << "}";
+				}
+				out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+			}
+
+			void write_chrome_trace( std::string const &filename ) {
+				std::ofstream out( filename );
+				if( !out ) {
+					throw std::runtime_error( "Could not open trace file '" + filename +
+					                          "'" );
+				}
+				write_chrome_trace( out );
+			}
+		} // namespace trace
+	}   // namespace imaging
+} // namespace daw
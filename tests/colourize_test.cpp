@@ -0,0 +1,218 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "filterdawgs.h"
+#include "filterdawgscolourize.h"
+#include "genericimage.h"
+#include "parallelchunks.h"
+#include "repaintkernels.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+	using formula_t = FilterDAWGSColourize::repaint_formulas;
+
+	struct named_formula {
+		char const *name;
+		formula_t formula;
+	};
+
+	named_formula const all_formulas[] = {
+	  {"Ratio", formula_t::Ratio},           {"YUV", formula_t::YUV},
+	  {"Multiply 1", formula_t::Multiply_1}, {"Addition", formula_t::Addition},
+	  {"Multiply 2", formula_t::Multiply_2}, {"HSL", formula_t::HSL}};
+
+	// Call func( Formula{}, formula, name ) for each repaint formula type
+	template<typename Func>
+	void for_each_formula_type( Func func ) {
+		func( repaint::ratio{}, formula_t::Ratio, "Ratio" );
+		func( repaint::yuv{}, formula_t::YUV, "YUV" );
+		func( repaint::multiply_1{}, formula_t::Multiply_1, "Multiply 1" );
+		func( repaint::addition{}, formula_t::Addition, "Addition" );
+		func( repaint::multiply_2{}, formula_t::Multiply_2, "Multiply 2" );
+		func( repaint::hsl{}, formula_t::HSL, "HSL" );
+	}
+
+	// The three step colourize that the two fused passes replaced: store the
+	// repainted image as uint32_t, find its per channel min/max, then
+	// normalise each pixel into 0-255
+	template<typename Formula, typename GS>
+	GenericImage<rgb3> reference_colourize( GenericImage<rgb3> const &image,
+	                                        GenericImage<GS> const &gs ) {
+		auto const width = image.width( );
+		auto const height = image.height( );
+		GenericImage<GenericRGB<uint32_t>> repainted( width, height );
+		Formula const repaint{};
+		impl::repaint_block block;
+		impl::repaint_result result;
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; x += impl::repaint_lanes ) {
+				auto const count = std::min( impl::repaint_lanes, width - x );
+				impl::load_repaint_block( image.row( y ) + x, gs.row( y ) + x, count,
+				                          block );
+				repaint( block, result );
+				for( size_t n = 0; n < count; ++n ) {
+					repainted( y, x + n ) = GenericRGB<uint32_t>(
+					  result.red[n], result.green[n], result.blue[n] );
+				}
+			}
+		}
+
+		GenericRGB<uint32_t> pd_min{std::numeric_limits<uint32_t>::max( )};
+		GenericRGB<uint32_t> pd_max{std::numeric_limits<uint32_t>::min( )};
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				min( repainted( y, x ), pd_min );
+				max( repainted( y, x ), pd_max );
+			}
+		}
+		// A flat repaint normalises to black
+		auto const range = pd_max.max( ) - pd_min.min( );
+		auto const mul_fact =
+		  range == 0 ? 0.0f : 255.0f / static_cast<float>( range );
+
+		GenericImage<rgb3> output( width, height );
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				auto const &rgb = repainted( y, x );
+				auto const channel = [&]( uint32_t const value,
+				                          uint32_t const minimum ) {
+					auto const scaled = static_cast<int32_t>(
+					  static_cast<float>( value - minimum ) * mul_fact );
+					return static_cast<uint8_t>(
+					  std::min( std::max( scaled, 0 ), 255 ) );
+				};
+				output( y, x ) = rgb3( channel( rgb.red, pd_min.red ),
+				                       channel( rgb.green, pd_min.green ),
+				                       channel( rgb.blue, pd_min.blue ) );
+			}
+		}
+		return output;
+	}
+
+	template<typename GS>
+	bool check_reference( GenericImage<rgb3> const &image,
+	                      GenericImage<GS> const &gs,
+	                      std::string const &name ) {
+		bool passed = true;
+		for_each_formula_type( [&]( auto formula_type, formula_t const formula,
+		                            char const *formula_name ) {
+			using Formula = decltype( formula_type );
+			auto const expected = reference_colourize<Formula>( image, gs );
+			passed &= check( std::string( formula_name ) + " " + name +
+			                   " matches the three step colourize",
+			                 same_pixels( FilterDAWGSColourize::filter( image, gs,
+			                                                            formula ),
+			                              expected ) );
+		} );
+		return passed;
+	}
+
+	// filter<Formula> and the runtime switch on repaint_formulas must agree,
+	// e.g. a case returning the wrong formula type would not
+	template<typename GS>
+	bool check_dispatch( GenericImage<rgb3> const &image,
+	                     GenericImage<GS> const &gs, std::string const &name ) {
+		bool passed = true;
+		for_each_formula_type( [&]( auto formula_type, formula_t const formula,
+		                            char const *formula_name ) {
+			using Formula = decltype( formula_type );
+			auto const expected =
+			  FilterDAWGSColourize::filter<Formula>( image, gs );
+			passed &= check( std::string( formula_name ) + " " + name +
+			                   " runtime dispatch",
+			                 same_pixels( FilterDAWGSColourize::filter( image, gs,
+			                                                            formula ),
+			                              expected ) );
+		} );
+		return passed;
+	}
+
+	// The range pass merges a min/max partial per chunk, so the output must
+	// not depend on how many chunks the rows are split into
+	template<typename GS>
+	bool check_thread_limits( GenericImage<rgb3> const &image,
+	                          GenericImage<GS> const &gs,
+	                          std::string const &gs_name ) {
+		bool passed = true;
+		for( auto const &f : all_formulas ) {
+			set_thread_limit( 1 );
+			auto const serial = FilterDAWGSColourize::filter( image, gs, f.formula );
+			for( size_t const limit : {size_t{0}, size_t{3}} ) {
+				set_thread_limit( limit );
+				auto const parallel =
+				  FilterDAWGSColourize::filter( image, gs, f.formula );
+				passed &= check( std::string( f.name ) + " " + gs_name +
+				                   " thread limit " + std::to_string( limit ),
+				                 same_pixels( serial, parallel ) );
+			}
+		}
+		set_thread_limit( 0 );
+		return passed;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	// Enough rows for several chunks
+	auto const image = make_image( 203, 157, 29 );
+	auto const gs = FilterDAWGS::filter_gs( image );
+	auto const gs_rgb = FilterDAWGS::filter( image );
+
+	bool passed = true;
+	passed &= check_thread_limits( image, gs, "uint8_t" );
+	passed &= check_thread_limits( image, gs_rgb, "rgb3" );
+	passed &= check_reference( image, gs, "uint8_t" );
+	passed &= check_reference( image, gs_rgb, "rgb3" );
+	passed &= check_dispatch( image, gs, "uint8_t" );
+	passed &= check_dispatch( image, gs_rgb, "rgb3" );
+
+	{
+		// Every repainted pixel equal, so repaint_range::scale( ) is 0
+		GenericImage<rgb3> flat( 37, 21 );
+		GenericImage<uint8_t> flat_gs( 37, 21 );
+		for( size_t y = 0; y < flat.height( ); ++y ) {
+			for( size_t x = 0; x < flat.width( ); ++x ) {
+				flat( y, x ) = rgb3( 90, 60, 30 );
+				flat_gs( y, x ) = 77;
+			}
+		}
+		GenericImage<rgb3> const black( 37, 21 );
+		passed &= check_reference( flat, flat_gs, "flat" );
+		passed &= check( "flat is black",
+		                 same_pixels( FilterDAWGSColourize::filter( flat, flat_gs ),
+		                              black ) );
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "colourize tests passed\n";
+	return EXIT_SUCCESS;
+}
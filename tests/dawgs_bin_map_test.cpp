@@ -0,0 +1,145 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "dawgsbinmap.h"
+#include "filterdawgs.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	// The level of a key is the first bin boundary >= the key
+	uint8_t reference_level( DAWGSBinMap::bins_t const &bins,
+	                         uint32_t const key ) {
+		return static_cast<uint8_t>(
+		  std::lower_bound( bins.begin( ), bins.end( ), key ) - bins.begin( ) );
+	}
+
+	std::vector<uint32_t> sorted_keys( size_t const count, uint32_t state ) {
+		std::vector<uint32_t> keys{};
+		while( keys.size( ) < count ) {
+			state = state * 1103515245U + 12345U;
+			keys.push_back( state % FilterDAWGS::too_gs( 255, 255, 255 ) );
+			if( keys.size( ) == count ) {
+				std::sort( keys.begin( ), keys.end( ) );
+				keys.erase( std::unique( keys.begin( ), keys.end( ) ), keys.end( ) );
+			}
+		}
+		return keys;
+	}
+
+	bool check_map( size_t const key_count ) {
+		auto const keys =
+		  sorted_keys( key_count, static_cast<uint32_t>( key_count ) );
+		auto const bin_map = DAWGSBinMap::from_keys( keys );
+		auto const &bins = bin_map.bins( );
+
+		// Every key, and the values either side of it, through both the block
+		// map and operator( )
+		std::vector<uint32_t> probes{};
+		for( auto const key : keys ) {
+			probes.push_back( key );
+			probes.push_back( key + 1 );
+			if( key > 0 ) {
+				probes.push_back( key - 1 );
+			}
+		}
+		probes.erase( std::remove_if( probes.begin( ), probes.end( ),
+		                              [&]( uint32_t const key ) {
+			                              return key > keys.back( );
+		                              } ),
+		              probes.end( ) );
+		std::vector<uint8_t> levels( probes.size( ) );
+		bin_map.map( probes.data( ), probes.data( ) + probes.size( ),
+		             levels.data( ), []( uint32_t const key ) { return key; } );
+
+		bool passed = check( "last bin", bins.back( ) == keys.back( ) );
+		for( size_t n = 0; n < probes.size( ); ++n ) {
+			auto const expected = reference_level( bins, probes[n] );
+			if( levels[n] != expected || bin_map( probes[n] ) != expected ) {
+				std::cerr << "key " << probes[n] << ": expected "
+				          << static_cast<int>( expected ) << " got "
+				          << static_cast<int>( levels[n] ) << '\n';
+				return check( "map", false );
+			}
+		}
+		return passed;
+	}
+
+	// FilterDAWGS::filter_gs against a direct sort, unique and lower_bound
+	// implementation of the algorithm
+	bool check_filter( size_t const width, size_t const height ) {
+		auto const image = make_image( width, height, 3 );
+
+		std::vector<uint32_t> keys{};
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				keys.push_back( FilterDAWGS::too_gs( image( y, x ) ) );
+			}
+		}
+		std::sort( keys.begin( ), keys.end( ) );
+		keys.erase( std::unique( keys.begin( ), keys.end( ) ), keys.end( ) );
+		if( !check( "key count", keys.size( ) > 256 ) ) {
+			return false;
+		}
+		DAWGSBinMap::bins_t bins{};
+		auto const inc = static_cast<float>( keys.size( ) ) / 256.0f;
+		for( size_t n = 0; n < 255; ++n ) {
+			bins[n] = keys[static_cast<size_t>( static_cast<float>( n ) * inc )];
+		}
+		bins[255] = keys.back( );
+
+		auto const output = FilterDAWGS::filter_gs( image );
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				auto const expected =
+				  reference_level( bins, FilterDAWGS::too_gs( image( y, x ) ) );
+				if( output( y, x ) != expected ) {
+					return check( "filter", false );
+				}
+			}
+		}
+		return true;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	passed &= check_map( 257 );
+	passed &= check_map( 1000 );
+	passed &= check_map( 100000 );
+	passed &= check_filter( 203, 151 );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "dawgs bin map tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "dawgskeyset.h"
+#include "filterdawgs.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	bool check_key_set( ) {
+		std::set<uint32_t> expected = {0,     1,     63,     64,   65,
+		                               4095,  4096,  123457, 8000000,
+		                               DAWGSKeySet::max_key};
+		// Spread the keys over three partial sets, with some overlap
+		std::vector<DAWGSKeySet> partials( 3 );
+		size_t n = 0;
+		for( auto const key : expected ) {
+			partials[n++ % partials.size( )].insert( key );
+			partials[n % partials.size( )].insert( key );
+		}
+		auto const keys = DAWGSKeySet::merge( std::move( partials ) );
+
+		bool passed = check( "size", keys.size( ) == expected.size( ) );
+		size_t pos = 0;
+		for( auto const key : expected ) {
+			passed &= check( "contains", keys.contains( key ) );
+			passed &= check( "operator[]", keys[pos++] == key );
+		}
+		passed &= check( "not contains", !keys.contains( 2 ) &&
+		                                   !keys.contains( 4097 ) );
+		passed &= check( "back", keys.back( ) == DAWGSKeySet::max_key );
+
+		bool threw = false;
+		try {
+			keys[keys.size( )];
+		} catch( std::exception const & ) { threw = true; }
+		passed &= check( "out of range", threw );
+		return passed;
+	}
+
+	bool check_engines( char const *name, GenericImage<rgb3> const &image ) {
+		auto const sorted =
+		  FilterDAWGS::filter( image, FilterDAWGS::key_engines::sort_unique );
+		auto const bitset =
+		  FilterDAWGS::filter( image, FilterDAWGS::key_engines::bitset );
+		auto const sorted_gs =
+		  FilterDAWGS::filter_gs( image, FilterDAWGS::key_engines::sort_unique );
+		auto const bitset_gs =
+		  FilterDAWGS::filter_gs( image, FilterDAWGS::key_engines::bitset );
+		return check( name, same_pixels( sorted, bitset ) &&
+		                      same_pixels( sorted_gs, bitset_gs ) );
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = check_key_set( );
+	// Few keys take the small grayscale path, many keys the bin map
+	passed &=
+	  check_engines( "engines, few keys", make_image( 67, 45, 11, 0x03 ) );
+	passed &= check_engines( "engines, many keys", make_image( 301, 217, 11 ) );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "dawgs key set tests passed\n";
+	return EXIT_SUCCESS;
+}
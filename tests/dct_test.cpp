@@ -0,0 +1,188 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include <daw/daw_math.h>
+
+#include "dct.h"
+#include "genericimage.h"
+
+namespace {
+	using namespace daw::imaging;
+	using double_block = std::array<double, dct::block_size>;
+
+	// The direct O(n^4) double precision transforms, used as the oracle
+	double coefficient_scale( size_t const k ) {
+		return k == 0 ? 1.0 / std::sqrt( 2.0 ) : 1.0;
+	}
+
+	double basis( size_t const x, size_t const u ) {
+		return std::cos( static_cast<double>( ( 2 * x + 1 ) * u ) *
+		                 daw::math::PI<double> / 16.0 );
+	}
+
+	double_block reference_forward( double_block const &samples ) {
+		double_block result{};
+		for( size_t v = 0; v < 8; ++v ) {
+			for( size_t u = 0; u < 8; ++u ) {
+				double z = 0.0;
+				for( size_t y = 0; y < 8; ++y ) {
+					for( size_t x = 0; x < 8; ++x ) {
+						z += samples[y * 8 + x] * basis( x, u ) * basis( y, v );
+					}
+				}
+				result[v * 8 + u] =
+				  0.25 * coefficient_scale( u ) * coefficient_scale( v ) * z;
+			}
+		}
+		return result;
+	}
+
+	double_block reference_inverse( double_block const &coefficients ) {
+		double_block result{};
+		for( size_t y = 0; y < 8; ++y ) {
+			for( size_t x = 0; x < 8; ++x ) {
+				double z = 0.0;
+				for( size_t v = 0; v < 8; ++v ) {
+					for( size_t u = 0; u < 8; ++u ) {
+						z += coefficient_scale( u ) * coefficient_scale( v ) *
+						     coefficients[v * 8 + u] * basis( x, u ) * basis( y, v );
+					}
+				}
+				result[y * 8 + x] = z / 4.0;
+			}
+		}
+		return result;
+	}
+
+	template<typename Block>
+	double max_difference( Block const &block, double_block const &expected ) {
+		double result = 0.0;
+		for( size_t n = 0; n < dct::block_size; ++n ) {
+			result = std::max(
+			  result, std::abs( static_cast<double>( block[n] ) - expected[n] ) );
+		}
+		return result;
+	}
+
+	bool check( char const *name, double const difference,
+	            double const tolerance ) {
+		std::cout << name << ": max difference " << difference << " (tolerance "
+		          << tolerance << ")\n";
+		return difference <= tolerance;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	std::mt19937 rng( 42 );
+	std::uniform_int_distribution<int32_t> level( 0, 255 );
+
+	double float_forward = 0.0;
+	double float_inverse = 0.0;
+	double int_forward = 0.0;
+	double int_inverse = 0.0;
+
+	for( size_t test = 0; test < 2000; ++test ) {
+		double_block samples{};
+		dct::float_block float_samples{};
+		dct::int_block int_samples{};
+		for( size_t n = 0; n < dct::block_size; ++n ) {
+			// Mix noise, flat blocks and hard edges
+			auto const value = test % 3 == 0
+			                     ? level( rng )
+			                     : ( test % 3 == 1 ? static_cast<int32_t>( test % 256 )
+			                                       : ( n % 8 < 4 ? 0 : 255 ) );
+			samples[n] = value;
+			float_samples[n] = static_cast<float>( value );
+			int_samples[n] = value;
+		}
+		auto const coefficients = reference_forward( samples );
+
+		dct::forward( float_samples );
+		float_forward =
+		  std::max( float_forward, max_difference( float_samples, coefficients ) );
+		dct::forward( int_samples );
+		int_forward =
+		  std::max( int_forward, max_difference( int_samples, coefficients ) );
+
+		// Inverse from the exact coefficients, rounded for the integer version
+		dct::float_block float_coefficients{};
+		dct::int_block int_coefficients{};
+		for( size_t n = 0; n < dct::block_size; ++n ) {
+			float_coefficients[n] = static_cast<float>( coefficients[n] );
+			int_coefficients[n] = static_cast<int32_t>( std::lround( coefficients[n] ) );
+		}
+		auto const rebuilt = reference_inverse( coefficients );
+		dct::inverse( float_coefficients );
+		float_inverse =
+		  std::max( float_inverse, max_difference( float_coefficients, rebuilt ) );
+
+		auto rounded = rebuilt;
+		for( auto &value : rounded ) {
+			value = std::round( value );
+		}
+		dct::inverse( int_coefficients );
+		int_inverse =
+		  std::max( int_inverse, max_difference( int_coefficients, rounded ) );
+	}
+
+	// Whole image round trip through the batch interface, with partial edge
+	// blocks
+	GenericImage<uint8_t> image( 37, 21 );
+	for( size_t y = 0; y < image.height( ); ++y ) {
+		for( size_t x = 0; x < image.width( ); ++x ) {
+			image( y, x ) = static_cast<uint8_t>( level( rng ) );
+		}
+	}
+	auto const round_trip = [&image]( auto const &blocks ) {
+		auto const result =
+		  dct::inverse_blocks( blocks, image.width( ), image.height( ) );
+		double difference = 0.0;
+		for( size_t y = 0; y < image.height( ); ++y ) {
+			for( size_t x = 0; x < image.width( ); ++x ) {
+				difference =
+				  std::max( difference, std::abs( static_cast<double>( result( y, x ) ) -
+				                                  static_cast<double>( image( y, x ) ) ) );
+			}
+		}
+		return difference;
+	};
+
+	bool result = true;
+	result &= check( "float forward", float_forward, 0.01 );
+	result &= check( "float inverse", float_inverse, 0.01 );
+	result &= check( "int forward", int_forward, 1.0 );
+	result &= check( "int inverse", int_inverse, 1.0 );
+	result &= check( "float image round trip",
+	                 round_trip( dct::forward_blocks<dct::float_block>( image ) ),
+	                 0.0 );
+	result &= check( "int image round trip",
+	                 round_trip( dct::forward_blocks<dct::int_block>( image ) ), 1.0 );
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
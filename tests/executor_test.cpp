@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "executor.h"
+#include "test_helpers.h"
+
+int main( int, char ** ) {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+	bool passed = true;
+
+	{
+		// Items arrive in order and the producer never gets more than the
+		// capacity ahead of the consumer
+		constexpr size_t capacity = 2;
+		constexpr size_t item_count = 1000;
+		BoundedQueue<size_t> queue( capacity );
+		std::atomic<size_t> pushed{0};
+		std::atomic<size_t> popped{0};
+		std::atomic<bool> bounded{true};
+		std::vector<size_t> received{};
+
+		Executor executor{};
+		executor.spawn( [&]( ) {
+			for( size_t n = 0; n < item_count; ++n ) {
+				queue.push( n );
+				++pushed;
+			}
+			queue.close( );
+		} );
+		executor.spawn( [&]( ) {
+			while( auto item = queue.pop( ) ) {
+				// One item may be pushed between the pop and this check
+				if( pushed - popped > capacity + 1 ) {
+					bounded = false;
+				}
+				++popped;
+				received.push_back( *item );
+			}
+		} );
+		executor.wait( );
+
+		bool in_order = received.size( ) == item_count;
+		for( size_t n = 0; in_order && n < item_count; ++n ) {
+			in_order = received[n] == n;
+		}
+		passed &= check( "queue order", in_order );
+		passed &= check( "queue bound", bounded );
+		passed &= check( "push after close", !queue.push( 0 ) );
+	}
+
+	{
+		Executor executor{};
+		executor.spawn( []( ) { throw std::runtime_error( "stage error" ); } );
+		bool rethrown = false;
+		try {
+			executor.wait( );
+		} catch( std::runtime_error const & ) { rethrown = true; }
+		passed &= check( "stage exception", rethrown );
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "executor tests passed\n";
+	return EXIT_SUCCESS;
+}
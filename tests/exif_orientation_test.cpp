@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "exiforientation.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	// SOI, an APP0 segment to skip, then an Exif APP1 segment whose IFD0 has
+	// an unrelated tag followed by Orientation
+	std::vector<uint8_t> make_jpeg( bool const big_endian,
+	                                uint16_t const orientation_value ) {
+		auto const u16 = [big_endian]( uint16_t const v ) {
+			auto const high = static_cast<uint8_t>( v >> 8U );
+			auto const low = static_cast<uint8_t>( v & 0xFFU );
+			return big_endian ? std::vector<uint8_t>{high, low}
+			                  : std::vector<uint8_t>{low, high};
+		};
+		auto const u32 = [&]( uint32_t const v ) {
+			auto high = u16( static_cast<uint16_t>( v >> 16U ) );
+			auto low = u16( static_cast<uint16_t>( v & 0xFFFFU ) );
+			auto &first = big_endian ? high : low;
+			auto const &second = big_endian ? low : high;
+			first.insert( first.end( ), second.begin( ), second.end( ) );
+			return first;
+		};
+		std::vector<uint8_t> tiff = {big_endian ? uint8_t{'M'} : uint8_t{'I'},
+		                             big_endian ? uint8_t{'M'} : uint8_t{'I'}};
+		auto const append = [&tiff]( std::vector<uint8_t> const &bytes ) {
+			tiff.insert( tiff.end( ), bytes.begin( ), bytes.end( ) );
+		};
+		append( u16( 42 ) );
+		append( u32( 8 ) );
+		append( u16( 2 ) );
+		// ImageWidth, LONG
+		append( u16( 0x0100 ) );
+		append( u16( 4 ) );
+		append( u32( 1 ) );
+		append( u32( 640 ) );
+		// Orientation, SHORT
+		append( u16( 0x0112 ) );
+		append( u16( 3 ) );
+		append( u32( 1 ) );
+		append( u16( orientation_value ) );
+		append( u16( 0 ) );
+		append( u32( 0 ) );
+
+		std::vector<uint8_t> jpeg = {0xFF, 0xD8, 0xFF, 0xE0,
+		                             0x00, 0x04, 0x00, 0x00};
+		auto const app1_length = static_cast<uint16_t>( 2 + 6 + tiff.size( ) );
+		jpeg.insert( jpeg.end( ),
+		             {0xFF, 0xE1, static_cast<uint8_t>( app1_length >> 8U ),
+		              static_cast<uint8_t>( app1_length & 0xFFU ), 'E', 'x', 'i',
+		              'f', 0, 0} );
+		jpeg.insert( jpeg.end( ), tiff.begin( ), tiff.end( ) );
+		jpeg.insert( jpeg.end( ), {0xFF, 0xD9} );
+		return jpeg;
+	}
+
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	for( uint16_t value = 1; value <= 8; ++value ) {
+		passed &= check( "tag value round trip",
+		                 exif::to_tag_value( exif::from_tag_value( value ) ) ==
+		                   value );
+	}
+
+	for( bool const big_endian : {false, true} ) {
+		auto jpeg = make_jpeg( big_endian, 6 );
+		auto const original = jpeg;
+		auto const tag = exif::find_orientation_tag( jpeg );
+		passed &= check( "find tag", static_cast<bool>( tag ) );
+		if( !tag ) {
+			continue;
+		}
+		auto const current = exif::read_orientation( jpeg, *tag );
+		passed &= check( "read tag", current == orientation::rotate_90 );
+
+		// A further 270 degrees undoes the 90 degrees of the tag
+		auto const rotated = compose( current, rotation( 3 ) );
+		exif::write_orientation( jpeg, *tag, rotated );
+		passed &= check( "write tag", exif::read_orientation( jpeg, *tag ) ==
+		                                orientation::identity );
+		passed &= check( "only the tag changes",
+		                 jpeg.size( ) == original.size( ) &&
+		                   std::equal( jpeg.begin( ), jpeg.begin( ) + tag->offset,
+		                               original.begin( ) ) &&
+		                   std::equal( jpeg.begin( ) + tag->offset + 2, jpeg.end( ),
+		                               original.begin( ) + tag->offset + 2 ) );
+	}
+
+	std::vector<uint8_t> const no_exif = {0xFF, 0xD8, 0xFF, 0xD9};
+	passed &= check( "no exif", !exif::find_orientation_tag( no_exif ) );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "exif orientation tests passed\n";
+	return EXIT_SUCCESS;
+}
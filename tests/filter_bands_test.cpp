@@ -0,0 +1,160 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "filterdawgs.h"
+#include "genericimage.h"
+#include "netpbm.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+	namespace fs = boost::filesystem;
+
+	bool same_levels( GenericImage<uint8_t> const &expected,
+	                  std::vector<uint8_t> const &levels ) {
+		if( levels.size( ) != expected.size( ) ) {
+			return false;
+		}
+		for( size_t y = 0; y < expected.height( ); ++y ) {
+			auto const *const row = levels.data( ) + y * expected.width( );
+			if( std::memcmp( expected.row( y ), row, expected.width( ) ) != 0 ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// filter_bands, reading from and writing to memory, against filter_gs
+	bool check_bands( std::string const &name, GenericImage<rgb3> const &image,
+	                  size_t const band_rows ) {
+		auto const width = image.width( );
+		std::vector<uint8_t> levels( image.size( ) );
+		FilterDAWGS::filter_bands(
+		  width, image.height( ),
+		  [&]( size_t const first_row, size_t const row_count, rgb3 *rows ) {
+			  for( size_t r = 0; r < row_count; ++r ) {
+				  std::copy_n( image.row( first_row + r ), width, rows + r * width );
+			  }
+		  },
+		  [&]( size_t const first_row, size_t const row_count,
+		       uint8_t const *band_levels ) {
+			  std::copy_n( band_levels, row_count * width,
+			               levels.data( ) + first_row * width );
+		  },
+		  band_rows );
+		return check( name,
+		              same_levels( FilterDAWGS::filter_gs( image ), levels ) );
+	}
+
+	// filter_netpbm from a P6 file to a P5 file, against filter_gs
+	bool check_netpbm( std::string const &name, GenericImage<rgb3> const &image,
+	                   size_t const band_rows ) {
+		auto const base = fs::temp_directory_path( ) /
+		                  fs::unique_path( "filter_bands_test-%%%%%%%%" );
+		auto const input = base.string( ) + ".ppm";
+		auto const output = base.string( ) + ".pgm";
+		{
+			std::ofstream file( input, std::ios::binary );
+			file << "P6\n" << image.width( ) << ' ' << image.height( ) << "\n255\n";
+			for( size_t y = 0; y < image.height( ); ++y ) {
+				for( size_t x = 0; x < image.width( ); ++x ) {
+					auto const &px = image( y, x );
+					file.put( static_cast<char>( px.red ) );
+					file.put( static_cast<char>( px.green ) );
+					file.put( static_cast<char>( px.blue ) );
+				}
+			}
+		}
+		FilterDAWGS::filter_netpbm( input, output, band_rows );
+
+		std::ifstream file( output, std::ios::binary );
+		std::string magic{};
+		size_t width = 0;
+		size_t height = 0;
+		unsigned max_value = 0;
+		file >> magic >> width >> height >> max_value;
+		file.get( );
+		std::vector<uint8_t> levels( width * height );
+		file.read( reinterpret_cast<char *>( levels.data( ) ),
+		           static_cast<std::streamsize>( levels.size( ) ) );
+		auto const read_all = static_cast<bool>( file );
+		file.close( );
+		fs::remove( input );
+		fs::remove( output );
+
+		return check( name,
+		              read_all && magic == "P5" && width == image.width( ) &&
+		                height == image.height( ) && max_value == 255 &&
+		                same_levels( FilterDAWGS::filter_gs( image ), levels ) );
+	}
+
+	// A device that accepts no data must fail the write or the close, never
+	// report success
+	bool check_netpbm_write_error( ) {
+		if( !fs::exists( "/dev/full" ) ) {
+			return true;
+		}
+		std::vector<uint8_t> const levels( 16 * 4, 128 );
+		try {
+			NetpbmWriter writer{"/dev/full", 16, 4};
+			writer.write_rows( 0, 4, levels.data( ) );
+			writer.close( );
+		} catch( std::runtime_error const & ) { return true; }
+		return check( "netpbm write error", false );
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	// Few keys take the small grayscale path, many keys the bin map.  The band
+	// sizes do not divide the heights
+	auto const few_keys = make_image( 71, 53, 5, 0x03 );
+	auto const many_keys = make_image( 213, 167, 5 );
+	for( size_t const band_rows : {1, 7, 64, 1000} ) {
+		auto const suffix = " " + std::to_string( band_rows ) + " rows";
+		passed &= check_bands( "bands, few keys" + suffix, few_keys, band_rows );
+		passed &= check_bands( "bands, many keys" + suffix, many_keys, band_rows );
+	}
+	passed &= check_netpbm( "netpbm, few keys", few_keys, 16 );
+	passed &= check_netpbm( "netpbm, many keys", many_keys, 16 );
+	passed &= check_netpbm_write_error( );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "filter bands tests passed\n";
+	return EXIT_SUCCESS;
+}
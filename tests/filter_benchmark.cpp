@@ -0,0 +1,381 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <daw/daw_benchmark.h>
+
+#include "filterdawgs.h"
+#include "filterdawgs2.h"
+#include "filterdawgscolourize.h"
+#include "filterrotate.h"
+#include "genericimage.h"
+#include "memoryaccounting.h"
+#include "parallelchunks.h"
+
+// Times image I/O, every filter and every repaint formula separately on
+// synthetic images, for each thread count, and writes the results as JSON
+namespace {
+	using namespace daw::imaging;
+	namespace fs = boost::filesystem;
+
+	struct image_spec {
+		size_t width;
+		size_t height;
+		// Distinct colours in the image, zero for a random colour per pixel
+		size_t colours;
+		bool gray;
+	};
+
+	// Deterministic for a given spec so runs can be compared
+	GenericImage<rgb3> make_image( image_spec const &spec ) {
+		std::mt19937 engine( 1 );
+		std::uniform_int_distribution<uint32_t> channel( 0, 255 );
+		auto const random_colour = [&]( ) {
+			auto const red = static_cast<uint8_t>( channel( engine ) );
+			if( spec.gray ) {
+				return rgb3( red, red, red );
+			}
+			return rgb3( red, static_cast<uint8_t>( channel( engine ) ),
+			             static_cast<uint8_t>( channel( engine ) ) );
+		};
+		std::vector<rgb3> palette{};
+		for( size_t n = 0; n < spec.colours; ++n ) {
+			palette.push_back( random_colour( ) );
+		}
+		std::uniform_int_distribution<size_t> index(
+		  0, palette.empty( ) ? 0 : palette.size( ) - 1 );
+
+		GenericImage<rgb3> image( spec.width, spec.height, no_init );
+		for( size_t y = 0; y < image.height( ); ++y ) {
+			auto row = image.row( y );
+			for( size_t x = 0; x < image.width( ); ++x ) {
+				row[x] =
+				  palette.empty( ) ? random_colour( ) : palette[index( engine )];
+			}
+		}
+		return image;
+	}
+
+	struct result {
+		std::string benchmark;
+		image_spec image;
+		// The --threads value, and the threads the filters could use after
+		// clamping it to the hardware
+		size_t requested_threads;
+		size_t threads;
+		std::vector<double> seconds;
+		// Peak bytes of image buffers and filter temporaries during one run
+		int64_t peak_bytes;
+	};
+
+	struct timing {
+		std::vector<double> seconds;
+		int64_t peak_bytes;
+	};
+
+	// One untimed warm up run, which also measures memory use, then runs
+	// timed runs
+	template<typename Func>
+	timing time_runs( size_t const runs, Func func ) {
+		int64_t peak_bytes = 0;
+		{
+			memory::scope const mem{};
+			func( );
+			peak_bytes = mem.get_usage( ).peak_bytes;
+		}
+		std::vector<double> seconds{};
+		seconds.reserve( runs );
+		for( size_t n = 0; n < runs; ++n ) {
+			auto const start = std::chrono::steady_clock::now( );
+			func( );
+			seconds.push_back( std::chrono::duration<double>(
+			                     std::chrono::steady_clock::now( ) - start )
+			                     .count( ) );
+		}
+		std::sort( seconds.begin( ), seconds.end( ) );
+		return timing{std::move( seconds ), peak_bytes};
+	}
+
+	// Nearest rank percentile of sorted samples
+	double percentile( std::vector<double> const &sorted, double const p ) {
+		if( sorted.empty( ) ) {
+			return 0.0;
+		}
+		auto const rank = static_cast<size_t>(
+		  p / 100.0 * static_cast<double>( sorted.size( ) - 1 ) + 0.5 );
+		return sorted[std::min( rank, sorted.size( ) - 1 )];
+	}
+
+	std::string json_string( std::string const &str ) {
+		std::string ret = "\"";
+		for( auto const c : str ) {
+			if( c == '"' || c == '\\' ) {
+				ret += '\\';
+			}
+			ret += c;
+		}
+		return ret + '"';
+	}
+
+	void write_json( std::ostream &out, std::vector<result> const &results ) {
+		out << "{\n\t\"hardware_threads\": " << impl::max_chunk_count( )
+		    << ",\n\t\"results\": [";
+		for( size_t n = 0; n < results.size( ); ++n ) {
+			auto const &r = results[n];
+			auto const median = percentile( r.seconds, 50.0 );
+			auto const mpixels =
+			  static_cast<double>( r.image.width * r.image.height ) / 1.0e6;
+			out << ( n == 0 ? "\n" : ",\n" ) << "\t\t{\"benchmark\": "
+			    << json_string( r.benchmark ) << ", \"width\": " << r.image.width
+			    << ", \"height\": " << r.image.height
+			    << ", \"colours\": " << r.image.colours
+			    << ", \"gray\": " << ( r.image.gray ? "true" : "false" )
+			    << ", \"requested_threads\": " << r.requested_threads
+			    << ", \"threads\": " << r.threads
+			    << ", \"runs\": " << r.seconds.size( ) << ", \"median_s\": " << median
+			    << ", \"p10_s\": " << percentile( r.seconds, 10.0 )
+			    << ", \"p90_s\": " << percentile( r.seconds, 90.0 )
+			    << ", \"min_s\": " << r.seconds.front( )
+			    << ", \"max_s\": " << r.seconds.back( ) << ", \"mpixels_per_s\": "
+			    << ( median > 0.0 ? mpixels / median : 0.0 )
+			    << ", \"peak_bytes\": " << r.peak_bytes << "}";
+		}
+		out << "\n\t]\n}\n";
+	}
+
+	template<typename T>
+	std::vector<T> parse_list( std::string const &str,
+	                           std::function<T( std::string const & )> parse ) {
+		std::vector<std::string> items{};
+		boost::split( items, str, boost::is_any_of( "," ) );
+		std::vector<T> result{};
+		for( auto const &item : items ) {
+			result.push_back( parse( item ) );
+		}
+		return result;
+	}
+
+	std::pair<size_t, size_t> parse_size( std::string const &str ) {
+		auto const pos = str.find( 'x' );
+		if( pos == std::string::npos ) {
+			throw std::runtime_error( "Sizes are given as WIDTHxHEIGHT, not '" +
+			                          str + "'" );
+		}
+		return {std::stoul( str.substr( 0, pos ) ),
+		        std::stoul( str.substr( pos + 1 ) )};
+	}
+
+	// 1, 2, 4... up to and including the hardware thread count
+	std::string default_thread_counts( ) {
+		auto const hw = impl::max_chunk_count( );
+		std::string ret{};
+		for( size_t n = 1; n < hw; n *= 2 ) {
+			ret += std::to_string( n ) + ",";
+		}
+		return ret + std::to_string( hw );
+	}
+
+	struct benchmark_case {
+		std::string name;
+		std::function<void( )> run;
+	};
+
+	std::vector<benchmark_case>
+	make_cases( GenericImage<rgb3> const &image,
+	            GenericImage<uint8_t> const &gs_image,
+	            std::string const &io_file ) {
+		std::vector<benchmark_case> cases = {
+		  {"to_file", [&]( ) { image.to_file( io_file ); }},
+		  {"from_file",
+		   [&]( ) { daw::do_not_optimize( from_file( io_file ) ); }},
+		  {"dawgs/sort_unique",
+		   [&]( ) {
+			   daw::do_not_optimize( FilterDAWGS::filter(
+			     image, FilterDAWGS::key_engines::sort_unique ) );
+		   }},
+		  {"dawgs/bitset",
+		   [&]( ) {
+			   daw::do_not_optimize(
+			     FilterDAWGS::filter( image, FilterDAWGS::key_engines::bitset ) );
+		   }},
+		  {"dawgs_gs",
+		   [&]( ) { daw::do_not_optimize( FilterDAWGS::filter_gs( image ) ); }},
+		  {"dawgs2",
+		   [&]( ) { daw::do_not_optimize( FilterDAWGS2::filter( image ) ); }}};
+
+		std::vector<std::pair<std::string, FilterDAWGSColourize::repaint_formulas>>
+		  formulas{};
+		for( auto const &formula : FilterDAWGSColourize::get_repaint_formulas( ) ) {
+			formulas.emplace_back( formula.first, formula.second );
+		}
+		std::sort( formulas.begin( ), formulas.end( ) );
+		for( auto const &formula : formulas ) {
+			auto const rf = formula.second;
+			cases.push_back( {"colourize/" + formula.first, [&, rf]( ) {
+				                  daw::do_not_optimize(
+				                    FilterDAWGSColourize::filter( image, gs_image,
+				                                                  rf ) );
+			                  }} );
+		}
+		for( uint32_t angle = 1; angle <= 3; ++angle ) {
+			cases.push_back( {"rotate/" + std::to_string( angle * 90 ),
+			                  [&, angle]( ) {
+				                  daw::do_not_optimize(
+				                    FilterRotate::filter( image, angle ) );
+			                  }} );
+		}
+		return cases;
+	}
+} // namespace
+
+int main( int argc, char **argv ) {
+	namespace po = boost::program_options;
+
+	std::string sizes_arg{};
+	std::string colours_arg{};
+	std::string threads_arg{};
+	std::string only{};
+	std::string output{};
+	std::string io_format{};
+	size_t runs = 7;
+	bool skip_gray = false;
+
+	po::options_description desc( "Options" );
+	desc.add_options( )( "help", "print option descriptions" )(
+	  "sizes", po::value<std::string>( &sizes_arg )
+	             ->default_value( "640x480,1920x1080,4096x3072" ),
+	  "comma separated WIDTHxHEIGHT image sizes" )(
+	  "colours", po::value<std::string>( &colours_arg )->default_value( "256,0" ),
+	  "comma separated distinct colour counts, 0 for a random colour per "
+	  "pixel" )( "no-gray", po::bool_switch( &skip_gray ),
+	             "skip the already gray copies of each image" )(
+	  "threads",
+	  po::value<std::string>( &threads_arg )
+	    ->default_value( default_thread_counts( ) ),
+	  "comma separated thread limits.  The JSON records each limit and the "
+	  "threads it allowed, which is at most the hardware thread count" )(
+	  "runs", po::value<size_t>( &runs )->default_value( 7 ),
+	  "timed runs of each benchmark" )(
+	  "only", po::value<std::string>( &only ),
+	  "only run benchmarks whose name contains this" )(
+	  "io-format", po::value<std::string>( &io_format )->default_value( "jpg" ),
+	  "file extension, and so format, used by from_file and to_file" )(
+	  "output,o", po::value<std::string>( &output ),
+	  "JSON output file, standard output when not given" );
+
+	try {
+		po::variables_map vm{};
+		po::store( po::parse_command_line( argc, argv, desc ), vm );
+		if( vm.count( "help" ) != 0 ) {
+			std::cout << "Usage: " << argv[0] << " [options]\n" << desc << '\n';
+			return EXIT_SUCCESS;
+		}
+		po::notify( vm );
+	} catch( std::exception const &ex ) {
+		std::cerr << ex.what( ) << "\n" << desc << '\n';
+		return EXIT_FAILURE;
+	}
+
+	try {
+		auto const sizes = parse_list<std::pair<size_t, size_t>>(
+		  sizes_arg, &parse_size );
+		auto const colours = parse_list<size_t>(
+		  colours_arg, []( std::string const &s ) { return std::stoul( s ); } );
+		auto const threads = parse_list<size_t>(
+		  threads_arg, []( std::string const &s ) { return std::stoul( s ); } );
+		runs = std::max( runs, static_cast<size_t>( 1 ) );
+
+		std::vector<image_spec> specs{};
+		for( auto const &size : sizes ) {
+			for( auto const colour_count : colours ) {
+				specs.push_back( {size.first, size.second, colour_count, false} );
+				if( !skip_gray ) {
+					specs.push_back( {size.first, size.second, colour_count, true} );
+				}
+			}
+		}
+
+		auto const io_file =
+		  ( fs::temp_directory_path( ) /
+		    fs::unique_path( "filter_benchmark-%%%%%%%%." + io_format ) )
+		    .string( );
+
+		std::vector<result> results{};
+		for( auto const &spec : specs ) {
+			auto const image = make_image( spec );
+			auto const gs_image = FilterDAWGS::filter_gs( image );
+			// from_file needs the file to_file writes
+			image.to_file( io_file );
+			auto const cases = make_cases( image, gs_image, io_file );
+			for( auto const requested : threads ) {
+				set_thread_limit( requested );
+				auto const thread_count = impl::max_chunk_count( );
+				for( auto const &c : cases ) {
+					if( !only.empty( ) && c.name.find( only ) == std::string::npos ) {
+						continue;
+					}
+					auto t = time_runs( runs, c.run );
+					results.push_back( {c.name, spec, requested, thread_count,
+					                    std::move( t.seconds ), t.peak_bytes} );
+					std::cerr << c.name << " " << spec.width << "x" << spec.height
+					          << " colours=" << spec.colours
+					          << ( spec.gray ? " gray" : "" )
+					          << " threads=" << thread_count << ": "
+					          << daw::utility::format_seconds(
+					               percentile( results.back( ).seconds, 50.0 ), 2 )
+					          << " peak=" << results.back( ).peak_bytes << "B\n";
+				}
+			}
+			set_thread_limit( 0 );
+		}
+		fs::remove( io_file );
+
+		if( output.empty( ) ) {
+			write_json( std::cout, results );
+		} else {
+			std::ofstream out( output );
+			daw::exception::daw_throw_on_false( out.good( ),
+			                                    "Could not open output file" );
+			write_json( out, results );
+		}
+	} catch( std::exception const &ex ) {
+		std::cerr << ex.what( ) << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "dawgs2lut.h"
+#include "filterdawgs2.h"
+#include "genericimage.h"
+#include "parallelchunks.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	// The channel sums are integers and the mapping is per pixel, so the
+	// output must not depend on how many chunks the rows are split into
+	bool check_thread_limits( GenericImage<rgb3> const &image ) {
+		auto const planar = to_planar( image );
+		set_thread_limit( 1 );
+		auto const serial = FilterDAWGS2::filter( image );
+		auto const serial_gs = FilterDAWGS2::filter_gs( image );
+		auto const serial_planar = FilterDAWGS2::filter_gs( planar );
+
+		bool passed = true;
+		for( size_t const limit : {size_t{0}, size_t{3}} ) {
+			set_thread_limit( limit );
+			auto const name = " thread limit " + std::to_string( limit );
+			passed &= check( "filter" + name,
+			                 same_pixels( serial, FilterDAWGS2::filter( image ) ) );
+			passed &=
+			  check( "filter_gs" + name,
+			         same_pixels( serial_gs, FilterDAWGS2::filter_gs( image ) ) );
+			passed &= check(
+			  "planar filter_gs" + name,
+			  same_pixels( serial_planar, FilterDAWGS2::filter_gs( planar ) ) );
+		}
+		set_thread_limit( 0 );
+		return passed;
+	}
+
+	// Every pixel through the lookup tables against the double formula they
+	// replaced, for channel means red, green and blue.  Only levels below 256
+	// are compared, above that the tables saturate where the old code
+	// wrapped.  The tables may round up a level that the double formula puts
+	// within a few 2^-20 of the next integer, as they do exact integers that
+	// the double formula lands just under
+	bool check_lut( uintmax_t const red, uintmax_t const green,
+	                uintmax_t const blue ) {
+		auto const lut = DAWGS2LUT::from_sums( DAWGS2Sums{red, green, blue}, 1 );
+		auto const mx = static_cast<double>( std::max( {red, green, blue} ) );
+		auto const weight_red = static_cast<double>( red ) / mx;
+		auto const weight_green = static_cast<double>( green ) / mx;
+		auto const weight_blue = static_cast<double>( blue ) / mx;
+		auto const dv = ( weight_red + weight_green + weight_blue ) / 3.0;
+		auto const tolerance =
+		  4.0 / static_cast<double>( 1U << DAWGS2LUT::fraction_bits );
+
+		size_t compared = 0;
+		size_t mismatches = 0;
+		for( uint32_t r = 0; r < 256; ++r ) {
+			for( uint32_t g = 0; g < 256; ++g ) {
+				for( uint32_t b = 0; b < 256; ++b ) {
+					auto const level = ( ( static_cast<double>( r ) / weight_red +
+					                       static_cast<double>( g ) / weight_green +
+					                       static_cast<double>( b ) / weight_blue ) /
+					                     dv ) /
+					                   3.0;
+					if( level >= 256.0 ) {
+						continue;
+					}
+					++compared;
+					auto const expected = static_cast<uint32_t>( level );
+					uint32_t const actual =
+					  lut( static_cast<uint8_t>( r ), static_cast<uint8_t>( g ),
+					       static_cast<uint8_t>( b ) );
+					auto const rounds_up = expected < 255 && actual == expected + 1 &&
+					                       std::ceil( level ) - level < tolerance;
+					if( actual != expected && !rounds_up ) {
+						++mismatches;
+					}
+				}
+			}
+		}
+		return check( "lut for means " + std::to_string( red ) + "," +
+		                std::to_string( green ) + "," + std::to_string( blue ),
+		              compared > 0 && mismatches == 0 );
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	// Enough rows for several chunks
+	passed &= check_thread_limits( make_image( 203, 157, 31 ) );
+
+	passed &= check_lut( 128, 128, 128 );
+	passed &= check_lut( 100, 150, 200 );
+	passed &= check_lut( 200, 90, 10 );
+	passed &= check_lut( 255, 1, 128 );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "filter dawgs2 tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "filterdawgs.h"
+#include "filterdawgs2.h"
+#include "filterdawgscolourize.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+	namespace fs = boost::filesystem;
+
+	// Every pixel of image has all three channels equal to gs
+	bool same_levels( GenericImage<rgb3> const &image,
+	                  GenericImage<uint8_t> const &gs ) {
+		if( image.width( ) != gs.width( ) || image.height( ) != gs.height( ) ) {
+			return false;
+		}
+		for( size_t y = 0; y < gs.height( ); ++y ) {
+			for( size_t x = 0; x < gs.width( ); ++x ) {
+				auto const &px = image( y, x );
+				auto const level = gs( y, x );
+				if( px.red != level || px.green != level || px.blue != level ) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Expand a single channel image to three equal channels
+	GenericImage<rgb3> expand( GenericImage<uint8_t> const &gs ) {
+		GenericImage<rgb3> result( gs.width( ), gs.height( ) );
+		for( size_t y = 0; y < gs.height( ); ++y ) {
+			for( size_t x = 0; x < gs.width( ); ++x ) {
+				result( y, x ) = rgb3( gs( y, x ), gs( y, x ), gs( y, x ) );
+			}
+		}
+		return result;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	auto const image = make_image( 301, 199, 11 );
+
+	for( auto const engine : {FilterDAWGS::key_engines::bitset,
+	                          FilterDAWGS::key_engines::sort_unique} ) {
+		std::string const suffix =
+		  engine == FilterDAWGS::key_engines::bitset ? " bitset" : " sort_unique";
+		passed &= check( "FilterDAWGS::filter_gs" + suffix,
+		                 same_levels( FilterDAWGS::filter( image, engine ),
+		                              FilterDAWGS::filter_gs( image, engine ) ) );
+	}
+	passed &= check( "FilterDAWGS::filter_gs view",
+	                 same_levels( FilterDAWGS::filter( image ),
+	                              FilterDAWGS::filter_gs( image.view( ) ) ) );
+
+	auto const gs2 = FilterDAWGS2::filter_gs( image );
+	passed &= check( "FilterDAWGS2::filter_gs",
+	                 same_levels( FilterDAWGS2::filter( image ), gs2 ) );
+
+	// Colourizing from the single channel image matches the expanded one
+	auto const gs = FilterDAWGS::filter_gs( image );
+	auto const expanded = expand( gs );
+	for( auto const &formula : FilterDAWGSColourize::get_repaint_formulas( ) ) {
+		passed &= check(
+		  "FilterDAWGSColourize::filter gs " + formula.first,
+		  same_pixels( FilterDAWGSColourize::filter( image, gs, formula.second ),
+		               FilterDAWGSColourize::filter( image, expanded,
+		                                             formula.second ) ) );
+	}
+
+	// The 8bpp save path reads back as the same levels
+	auto const path = fs::temp_directory_path( ) /
+	                  fs::unique_path( "filter_gs_test-%%%%-%%%%.png" );
+	gs.to_file( path.string( ) );
+	auto const loaded = from_file( path.string( ) );
+	fs::remove( path );
+	passed &=
+	  check( "GenericImage<uint8_t>::to_file", same_levels( loaded, gs ) );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "filter_gs tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "filterrotate.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	bool same( rgb3 const &lhs, rgb3 const &rhs ) noexcept {
+		return lhs.red == rhs.red && lhs.green == rhs.green &&
+		       lhs.blue == rhs.blue;
+	}
+
+	// The input pixel at output row r, column c, rotated clockwise by
+	// angle * 90 degrees
+	rgb3 const &expected( GenericImage<rgb3> const &image, uint32_t const angle,
+	                      size_t const r, size_t const c ) {
+		auto const maxx = image.width( ) - 1;
+		auto const maxy = image.height( ) - 1;
+		switch( angle ) {
+		case 1:
+			return image( maxy - c, r );
+		case 2:
+			return image( maxy - r, maxx - c );
+		default:
+			return image( c, maxx - r );
+		}
+	}
+
+	bool check_rotate( size_t const width, size_t const height,
+	                   uint32_t const angle ) {
+		auto const name = "rotate " + std::to_string( 90 * angle ) + " " +
+		                  std::to_string( width ) + "x" + std::to_string( height );
+		auto const image = make_image( width, height, 23 );
+		auto const rotated = FilterRotate::filter( image, angle );
+		auto const out_width = angle == 2 ? width : height;
+		auto const out_height = angle == 2 ? height : width;
+		bool passed =
+		  rotated.width( ) == out_width && rotated.height( ) == out_height;
+		for( size_t r = 0; r < out_height && passed; ++r ) {
+			for( size_t c = 0; c < out_width; ++c ) {
+				passed &= same( rotated( r, c ), expected( image, angle, r, c ) );
+			}
+		}
+		return check( name, passed );
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	// Non square sizes that are not whole tiles or whole transpose blocks
+	size_t const sizes[][2] = {{1, 1},   {1, 7},    {3, 5},   {5, 3},
+	                           {4, 4},   {37, 71},  {71, 37}, {100, 33},
+	                           {67, 129}, {257, 65}};
+	for( auto const &size : sizes ) {
+		for( uint32_t angle = 1; angle <= 3; ++angle ) {
+			passed &= check_rotate( size[0], size[1], angle );
+		}
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "filter rotate tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <set>
@@ -34,10 +35,48 @@
 #include <daw/daw_exception.h>
 
 #include "filterdawgs.h"
+#include "filterrotate.h"
 
 int main( int argc, char **argv ) {
 	daw::exception::daw_throw_on_false( argc >= 2, "Must supply a source file" );
 	auto const input_image = daw::imaging::from_file( argv[1] );
+	{
+		auto const decode_time = daw::benchmark(
+		  [&]( ) { daw::do_not_optimize( daw::imaging::from_file( argv[1] ) ); } );
+		auto const mb = static_cast<double>( input_image.size( ) * sizeof( rgb3 ) ) /
+		                ( 1024.0 * 1024.0 );
+		std::cout << "from_file: " << daw::utility::format_seconds( decode_time, 2 )
+		          << " " << ( mb / decode_time ) << "MB/s\n";
+		if( argc >= 3 ) {
+			auto const encode_time =
+			  daw::benchmark( [&]( ) { input_image.to_file( argv[2] ); } );
+			std::cout << "to_file: " << daw::utility::format_seconds( encode_time, 2 )
+			          << " " << ( mb / encode_time ) << "MB/s\n";
+		}
+	}
+	{
+		// Rotation reads and writes every pixel once, so compare it to a memcpy
+		// of the same buffer
+		auto const bytes = input_image.size( ) * sizeof( rgb3 );
+		auto const gb = static_cast<double>( 2 * bytes ) /
+		                ( 1024.0 * 1024.0 * 1024.0 );
+		std::vector<rgb3> copy_buffer( input_image.size( ) );
+		auto const copy_time = daw::benchmark( [&]( ) {
+			std::memcpy( copy_buffer.data( ), input_image.begin( ), bytes );
+			daw::do_not_optimize( copy_buffer );
+		} );
+		std::cout << "memcpy: " << daw::utility::format_seconds( copy_time, 2 )
+		          << " " << ( gb / copy_time ) << "GB/s\n";
+		for( uint32_t angle = 1; angle <= 3; ++angle ) {
+			auto const rotate_time = daw::benchmark( [&]( ) {
+				daw::do_not_optimize(
+				  daw::imaging::FilterRotate::filter( input_image, angle ) );
+			} );
+			std::cout << "rotate " << ( angle * 90 ) << ": "
+			          << daw::utility::format_seconds( rotate_time, 2 ) << " "
+			          << ( gb / rotate_time ) << "GB/s\n";
+		}
+	}
 	auto const t1 = daw::benchmark( [img_ref = std::cref( input_image )]( ) {
 		auto const &img = img_ref.get( );
 		std::vector<uint32_t> valuepos{};
@@ -116,7 +155,7 @@ int main( int argc, char **argv ) {
 		mv.reserve( valuepos.size( ) );
 
 		auto item = valuepos.begin( );
-		for( size_t n = 0; n < valuepos.size( ); ++n ) {
+		for( size_t n = 0; n < valuepos.size( ); ++n, ++item ) {
 			mv.emplace( *item,
 			            static_cast<uint32_t>( static_cast<float>( n ) / inc ) );
 		}
@@ -127,35 +166,5 @@ int main( int argc, char **argv ) {
 	std::cout << "elapsed time method 3: "
 	          << daw::utility::format_seconds( t3, 2 ) << '\n';
 
-	auto const t4 = daw::benchmark( [img_ref = std::cref( input_image )]( ) {
-		// no parallel to valuepos
-		auto const &image_input = img_ref.get( );
-
-		std::set<uint32_t> valuepos{};
-
-		// Create a valuepos item for each distinct grayscale item in image
-		// and then set count to zero
-		// no parallel to valuepos
-		for( auto &rgb : image_input ) {
-			valuepos.insert( daw::imaging::FilterDAWGS::too_gs( rgb ) );
-		}
-
-		auto const inc = static_cast<float>( valuepos.size( ) ) / 256.0f;
-
-		std::unordered_map<uint32_t, uint32_t> mv{};
-		mv.reserve( valuepos.size( ) );
-
-		auto item = valuepos.begin( );
-		for( size_t n = 0; n < valuepos.size( ); ++n ) {
-			mv.emplace( *item,
-			            static_cast<uint32_t>( static_cast<float>( n ) / inc ) );
-		}
-
-		daw::do_not_optimize( mv );
-	} );
-
-	std::cout << "elapsed time method 4: "
-	          << daw::utility::format_seconds( t4, 2 ) << '\n';
-
 	return EXIT_SUCCESS;
 }
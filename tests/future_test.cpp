@@ -0,0 +1,95 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "filterdawgs.h"
+#include "filterrotate.h"
+#include "future.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+
+	{
+		auto const text = run_async( []( ) { return 20; } )
+		                    .then( []( int const value ) { return value + 1; } )
+		                    .then( []( int const value ) {
+			                    return std::to_string( value );
+		                    } );
+		passed &= check( "then", text.get( ) == "21" );
+
+		int side_effect = 0;
+		auto const done =
+		  text.then( [&side_effect]( std::string const & ) { side_effect = 1; } )
+		    .then( [&side_effect]( ) { return side_effect + 1; } );
+		passed &= check( "void continuation", done.get( ) == 2 );
+	}
+
+	{
+		bool continued = false;
+		auto const failed = run_async( []( ) -> int {
+			                    throw std::runtime_error( "async error" );
+		                    } ).then( [&continued]( int const value ) {
+			continued = true;
+			return value;
+		} );
+		bool rethrown = false;
+		try {
+			failed.get( );
+		} catch( std::runtime_error const & ) { rethrown = true; }
+		passed &= check( "error propagates", rethrown && !continued );
+	}
+
+	{
+		GenericImage<rgb3> image( 67, 41 );
+		for( size_t n = 0; n < image.size( ); ++n ) {
+			image[n] = rgb3( static_cast<uint8_t>( n * 7 ),
+			                 static_cast<uint8_t>( n / 67 ),
+			                 static_cast<uint8_t>( n * 13 ) );
+		}
+		auto const expected =
+		  FilterRotate::filter( FilterDAWGS::filter( image ), 1 );
+		auto const actual =
+		  FilterDAWGS::filter_async( image )
+		    .then( []( GenericImage<rgb3> const &gs ) {
+			    return FilterRotate::filter( gs, 1 );
+		    } );
+		passed &= check( "filter chain", same_pixels( actual.get( ), expected ) );
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "future tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	bool is_cache_aligned( void const *ptr ) noexcept {
+		return reinterpret_cast<uintptr_t>( ptr ) % cache_line_size == 0;
+	}
+
+	template<typename Image>
+	bool iteration_throws( Image &image ) {
+		try {
+			static_cast<void>( image.begin( ) );
+		} catch( std::runtime_error const & ) {
+			try {
+				static_cast<void>( image.end( ) );
+			} catch( std::runtime_error const & ) { return true; }
+		}
+		return false;
+	}
+
+	// Shape, stride and alignment of an image of pixel type T
+	template<typename T>
+	bool check_layout( std::string const &type_name, size_t const width,
+	                   size_t const height ) {
+		auto const name = type_name + " " + std::to_string( width ) + "x" +
+		                  std::to_string( height );
+		bool passed = true;
+
+		GenericImage<T> plain( width, height );
+		bool zeroed = plain.stride( ) == width && plain.is_contiguous( ) &&
+		              std::distance( plain.begin( ), plain.end( ) ) ==
+		                static_cast<std::ptrdiff_t>( width * height );
+		for( auto const &px : plain ) {
+			zeroed &= px == T{};
+		}
+		passed &= check( name + " default", zeroed );
+
+		GenericImage<T> raw( width, height, no_init );
+		bool written = raw.width( ) == width && raw.height( ) == height &&
+		               raw.size( ) == width * height && raw.is_contiguous( );
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				raw( y, x ) = static_cast<T>( y * width + x );
+			}
+		}
+		size_t n = 0;
+		for( auto const &px : raw ) {
+			written &= px == static_cast<T>( n++ );
+		}
+		passed &= check( name + " no_init", written );
+
+		GenericImage<T> padded( width, height, row_padding::cache_line, no_init );
+		auto const row_bytes = padded.stride( ) * sizeof( T );
+		bool layout = padded.stride( ) >= width &&
+		              row_bytes % cache_line_size == 0 &&
+		              row_bytes < width * sizeof( T ) + cache_line_size;
+		for( size_t y = 0; y < height; ++y ) {
+			layout &= is_cache_aligned( padded.row( y ) ) &&
+			          padded.row( y ) == padded.row( 0 ) + y * padded.stride( ) &&
+			          &padded( y, 0 ) == padded.row( y );
+		}
+		layout &= padded.view( ).pitch( ) == row_bytes;
+		passed &= check( name + " cache_line stride", layout );
+		passed &= check( name + " cache_line is_contiguous",
+		                 padded.is_contiguous( ) == ( padded.stride( ) == width ) );
+		if( !padded.is_contiguous( ) ) {
+			auto const &const_padded = padded;
+			passed &= check( name + " padded iteration throws",
+			                 iteration_throws( padded ) &&
+			                   iteration_throws( const_padded ) );
+		}
+		return passed;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	for( size_t width : {1U, 3U, 63U, 64U, 65U, 300U} ) {
+		passed &= check_layout<uint8_t>( "uint8_t", width, 5 );
+	}
+
+	// rgb3 is 3 bytes, so only multiples of 64 pixels need no padding
+	for( size_t width : {1U, 21U, 64U, 65U, 300U} ) {
+		auto const name = "rgb3 " + std::to_string( width );
+		GenericImage<rgb3> padded( width, 4, row_padding::cache_line, no_init );
+		auto const row_bytes = padded.stride( ) * sizeof( rgb3 );
+		bool layout = padded.stride( ) % cache_line_size == 0 &&
+		              padded.stride( ) >= width &&
+		              padded.stride( ) < width + cache_line_size;
+		for( size_t y = 0; y < padded.height( ); ++y ) {
+			layout &= is_cache_aligned( padded.row( y ) );
+		}
+		layout &= padded.view( ).pitch( ) == row_bytes;
+		passed &= check( name + " cache_line stride", layout );
+		if( padded.is_contiguous( ) ) {
+			passed &= check( name + " iteration",
+			                 padded.end( ) - padded.begin( ) ==
+			                   static_cast<std::ptrdiff_t>( padded.size( ) ) );
+		} else {
+			passed &= check( name + " padded iteration throws",
+			                 iteration_throws( padded ) );
+		}
+
+		GenericImage<rgb3> raw( width, 4, no_init );
+		passed &= check( name + " no_init", raw.stride( ) == width &&
+		                                      raw.is_contiguous( ) &&
+		                                      raw.end( ) - raw.begin( ) ==
+		                                        static_cast<std::ptrdiff_t>(
+		                                          raw.size( ) ) );
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "generic image tests passed\n";
+	return EXIT_SUCCESS;
+}
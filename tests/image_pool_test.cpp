@@ -0,0 +1,145 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+
+#include "genericimage.h"
+#include "imagebuffer.h"
+#include "imagepool.h"
+#include "memoryaccounting.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	// Every size maps to the smallest of 4 classes per power of two that
+	// holds it, and a class maps to itself
+	bool check_size_classes( ) {
+		bool passed = true;
+		passed &= check( "minimum class", ImagePool::size_class( 1 ) == 256 &&
+		                                    ImagePool::size_class( 256 ) == 256 );
+		passed &= check( "class steps", ImagePool::size_class( 257 ) == 320 &&
+		                                  ImagePool::size_class( 1000 ) == 1024 &&
+		                                  ImagePool::size_class( 1024 ) == 1024 &&
+		                                  ImagePool::size_class( 1025 ) == 1280 );
+		bool bounded = true;
+		for( size_t bytes = 257; bytes < 100000; bytes += 37 ) {
+			auto const class_bytes = ImagePool::size_class( bytes );
+			bounded &= bytes <= class_bytes && class_bytes * 4 <= bytes * 5 &&
+			           ImagePool::size_class( class_bytes ) == class_bytes;
+		}
+		passed &= check( "class bounds", bounded );
+		return passed;
+	}
+
+	bool check_hits_and_misses( ) {
+		ImagePool pool{};
+		auto *const first = pool.allocate( 1000, cache_line_size );
+		pool.deallocate( first, 1000, cache_line_size );
+		auto const cached = pool.stats( );
+		// Same class, so the cached buffer
+		auto *const second = pool.allocate( 1024, cache_line_size );
+		auto const hit = pool.stats( );
+		auto *const third = pool.allocate( 1000, cache_line_size );
+		auto const miss = pool.stats( );
+		pool.deallocate( second, 1024, cache_line_size );
+		pool.deallocate( third, 1000, cache_line_size );
+
+		bool passed = true;
+		passed &= check( "first miss", cached.hits == 0 && cached.misses == 1 &&
+		                                 cached.cached_bytes == 1024 );
+		passed &= check( "hit", second == first && hit.hits == 1 &&
+		                          hit.misses == 1 && hit.cached_bytes == 0 );
+		passed &= check( "second miss", miss.hits == 1 && miss.misses == 2 );
+		passed &= check( "both cached", pool.stats( ).cached_bytes == 2048 );
+		pool.release( );
+		passed &= check( "release", pool.stats( ).cached_bytes == 0 );
+		return passed;
+	}
+
+	// Buffers freed beyond the cap go back upstream
+	bool check_cap( ) {
+		ImagePool pool{2048};
+		void *buffers[3];
+		for( auto &buffer : buffers ) {
+			buffer = pool.allocate( 1024, cache_line_size );
+		}
+		for( auto *buffer : buffers ) {
+			pool.deallocate( buffer, 1024, cache_line_size );
+		}
+		bool passed = true;
+		passed &= check( "cap", pool.stats( ).cached_bytes == 2048 );
+		// Over aligned requests are not pooled
+		auto *const aligned = pool.allocate( 1024, 4 * cache_line_size );
+		pool.deallocate( aligned, 1024, 4 * cache_line_size );
+		auto const stats = pool.stats( );
+		passed &= check( "over aligned", stats.misses == 3 && stats.hits == 0 &&
+		                                   stats.cached_bytes == 2048 );
+		return passed;
+	}
+
+	// The pool is only used once selected
+	bool check_opt_in( ) {
+		bool passed = true;
+		passed &= check( "default resource", get_image_memory_resource( ) ==
+		                                       memory::counting_resource( ) );
+		auto &pool = default_image_pool( );
+		passed &= check( "default cap", ImagePool::default_max_cached_bytes <=
+		                                  ( size_t{1} << 27U ) );
+		auto const before = pool.stats( );
+		{ GenericImage<rgb3> const image( 320, 200 ); }
+		passed &= check( "unused pool", pool.stats( ).misses == before.misses );
+
+		set_image_memory_resource( &pool );
+		{
+			GenericImage<rgb3> const image( 320, 200 );
+			image_vector<uint32_t> const keys( 1000 );
+		}
+		{ GenericImage<rgb3> const image( 320, 200 ); }
+		auto const after = pool.stats( );
+		passed &= check( "selected pool", after.misses == before.misses + 2 &&
+		                                    after.hits == before.hits + 1 );
+		set_image_memory_resource( nullptr );
+		passed &= check( "reset resource", get_image_memory_resource( ) ==
+		                                     memory::counting_resource( ) );
+		pool.release( );
+		return passed;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	passed &= check_size_classes( );
+	passed &= check_hits_and_misses( );
+	passed &= check_cap( );
+	passed &= check_opt_in( );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "image pool tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <FreeImage.h>
+
+#include "filterdawgs.h"
+#include "fimage.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	bool same( rgb3 const &lhs, rgb3 const &rhs ) noexcept {
+		return lhs.red == rhs.red && lhs.green == rhs.green &&
+		       lhs.blue == rhs.blue;
+	}
+
+	// Enough distinct colours that the DAWGS filter has more than 256 keys
+	rgb3 pixel( size_t const y, size_t const x ) noexcept {
+		return rgb3( static_cast<uint8_t>( 13 * x + 7 * y ),
+		             static_cast<uint8_t>( 31 * y + x * x ),
+		             static_cast<uint8_t>( 5 * x * y + 3 ) );
+	}
+
+	// A bitmap with pixel( y, x ) at row y counted from the top.  FreeImage
+	// stores scanline 0 at the bottom and pads each scanline to 4 bytes
+	FreeImage make_bitmap( size_t const width, size_t const height,
+	                       int const bpp ) {
+		FreeImage result( FreeImage_Allocate( static_cast<int>( width ),
+		                                      static_cast<int>( height ), bpp ),
+		                  "Error allocating bitmap" );
+		auto const bytes_per_pixel = static_cast<size_t>( bpp ) / 8;
+		for( size_t y = 0; y < height; ++y ) {
+			auto *line = FreeImage_GetScanLine(
+			  result.ptr( ), static_cast<int>( height - 1 - y ) );
+			for( size_t x = 0; x < width; ++x, line += bytes_per_pixel ) {
+				auto const px = pixel( y, x );
+				line[FI_RGBA_RED] = px.red;
+				line[FI_RGBA_GREEN] = px.green;
+				line[FI_RGBA_BLUE] = px.blue;
+			}
+		}
+		return result;
+	}
+
+	bool check_view( size_t const width, size_t const height, int const bpp ) {
+		auto const name = "make_view " + std::to_string( width ) + "x" +
+		                  std::to_string( height ) + " " + std::to_string( bpp ) +
+		                  "bpp";
+		auto bitmap = make_bitmap( width, height, bpp );
+		auto const view = make_view( bitmap );
+		bool passed = true;
+		passed &= check( name + " shape", view.width( ) == width &&
+		                                    view.height( ) == height &&
+		                                    view.bottom_up( ) );
+		// 24bpp scanlines are padded to 4 bytes
+		auto const pitch = ( ( 3 * width + 3 ) / 4 ) * 4;
+		passed &= check( name + " pitch", view.pitch( ) == pitch );
+		auto const contiguous = height <= 1 && pitch == 3 * width;
+		passed &= check( name + " is_contiguous",
+		                 view.is_contiguous( ) == contiguous );
+
+		bool pixels = true;
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				pixels &= same( view( y, x ), pixel( y, x ) );
+			}
+		}
+		passed &= check( name + " pixels", pixels );
+
+		auto const image = GenericImage<rgb3>::from_view( view );
+		bool copied = true;
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				copied &= same( image( y, x ), pixel( y, x ) );
+			}
+		}
+		passed &= check( name + " from_view", copied );
+
+		passed &= check( name + " filter",
+		                 same_pixels( FilterDAWGS::filter( view ),
+		                              FilterDAWGS::filter( image ) ) );
+		return passed;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	// Widths with every amount of scanline padding
+	for( size_t width : {1U, 2U, 3U, 4U, 61U, 62U, 63U, 64U} ) {
+		for( size_t height : {1U, 2U, 47U} ) {
+			passed &= check_view( width, height, 24 );
+			passed &= check_view( width, height, 32 );
+		}
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "image view tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include "filterdawgs.h"
+#include "future.h"
+#include "genericimage.h"
+#include "imagebuffer.h"
+#include "imagepool.h"
+#include "memoryaccounting.h"
+#include "parallelchunks.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	auto const image_bytes = static_cast<int64_t>( 320 * 200 * sizeof( rgb3 ) );
+
+	{
+		memory::scope const outer{};
+		{
+			memory::scope const inner{};
+			GenericImage<rgb3> const image( 320, 200 );
+			passed &= check( "inner current",
+			                 inner.get_usage( ).current_bytes == image_bytes );
+		}
+		auto const usage = outer.get_usage( );
+		passed &= check( "outer peak", usage.peak_bytes == image_bytes &&
+		                                 usage.current_bytes == 0 &&
+		                                 usage.allocation_count == 1 );
+	}
+
+	{
+		// Allocations on the worker threads of a parallel loop count too
+		memory::scope const mem{};
+		impl::for_each_chunk(
+		  1024, 8, []( size_t, size_t const first, size_t const last ) {
+			  image_vector<uint8_t> const buffer( last - first );
+		  } );
+		auto const usage = mem.get_usage( );
+		passed &= check( "workers", usage.allocated_bytes == 1024 &&
+		                              usage.current_bytes == 0 );
+	}
+
+	{
+		GenericImage<rgb3> image( 320, 200 );
+		for( size_t n = 0; n < image.size( ); ++n ) {
+			image[n] = rgb3( static_cast<uint8_t>( n ), static_cast<uint8_t>( n / 7 ),
+			                 static_cast<uint8_t>( n / 320 ) );
+		}
+		memory::scope const mem{};
+		auto const output = FilterDAWGS::filter( image );
+		auto const usage = mem.get_usage( );
+		// The output, plus at least one key bitset that has been freed again
+		passed &= check( "filter", usage.current_bytes == image_bytes &&
+		                             usage.peak_bytes > image_bytes );
+	}
+
+	{
+		// Frees count towards the scope that allocated, whichever thread frees
+		std::optional<GenericImage<rgb3>> image{};
+		memory::scope const allocating{};
+		image.emplace( 320, 200 );
+		auto const before = allocating.get_usage( ).current_bytes;
+		int64_t freeing_bytes = -1;
+		std::thread( [&]( ) {
+			memory::scope const freeing{};
+			image.reset( );
+			freeing_bytes = freeing.get_usage( ).current_bytes;
+		} ).join( );
+		passed &= check( "free on another thread",
+		                 before == image_bytes && freeing_bytes == 0 &&
+		                   allocating.get_usage( ).current_bytes == 0 );
+	}
+
+	{
+		// Work run with run_async, e.g. filter_async, counts too.  The input is
+		// moved in, as a copy would be freed whenever the task is
+		GenericImage<rgb3> image( 320, 200 );
+		memory::scope const mem{};
+		auto const output = FilterDAWGS::filter_async( std::move( image ) );
+		output.get( );
+		auto const usage = mem.get_usage( );
+		passed &= check( "filter_async", usage.current_bytes == image_bytes &&
+		                                   usage.peak_bytes > image_bytes );
+	}
+
+	{
+		// Behind a pool the size class is counted, once, when the pool takes it
+		// from the heap, and until the pool releases it
+		auto &pool = default_image_pool( );
+		pool.release( );
+		set_image_memory_resource( &pool );
+		auto const class_bytes =
+		  static_cast<int64_t>( ImagePool::size_class( image_bytes ) );
+		memory::scope const mem{};
+		{ GenericImage<rgb3> const image( 320, 200 ); }
+		auto const first = mem.get_usage( );
+		{ GenericImage<rgb3> const image( 320, 200 ); }
+		auto const second = mem.get_usage( );
+		pool.release( );
+		passed &= check( "pool", first.current_bytes == class_bytes &&
+		                           first.allocation_count == 1 &&
+		                           second.allocation_count == 1 &&
+		                           mem.get_usage( ).current_bytes == 0 );
+		set_image_memory_resource( nullptr );
+	}
+
+	passed &= check( "no scope", memory::current_account( ) == nullptr );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "memory accounting tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "filterdawgs.h"
+#include "filterrotate.h"
+#include "genericimage.h"
+#include "orientedview.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	orientation const all_orientations[] = {
+	  orientation::identity,        orientation::transpose,
+	  orientation::flip_horizontal, orientation::rotate_90,
+	  orientation::flip_vertical,   orientation::rotate_270,
+	  orientation::rotate_180,      orientation::transverse};
+
+	GenericImage<rgb3> make_pattern( size_t const width, size_t const height ) {
+		GenericImage<rgb3> result( width, height );
+		for( size_t y = 0; y < height; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				result( y, x ) = rgb3( static_cast<uint8_t>( x * 7 + y ),
+				                       static_cast<uint8_t>( y * 13 ),
+				                       static_cast<uint8_t>( x ^ y ) );
+			}
+		}
+		return result;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	auto const image = make_pattern( 131, 77 );
+	bool passed = true;
+
+	// Views match the materialised rotations
+	for( uint32_t angle = 1; angle <= 3; ++angle ) {
+		auto const rotated = FilterRotate::filter( image, angle );
+		auto const view = FilterRotate::view( image, angle );
+		passed &= check( "rotate view", same_pixels( view, rotated ) );
+		passed &=
+		  check( "from_view", same_pixels( GenericImage<rgb3>::from_view( view ),
+		                                   rotated ) );
+		auto const expected = FilterDAWGS::filter_gs( rotated );
+		auto const actual = FilterDAWGS::filter_gs( view );
+		passed &= check( "filter_gs through view",
+		                 std::equal( expected.cbegin( ), expected.cend( ),
+		                             actual.cbegin( ), actual.cend( ) ) );
+	}
+
+	// Composing orientations is the same as viewing a view
+	for( auto const first : all_orientations ) {
+		auto const once = GenericImage<rgb3>::from_view( image.view( first ) );
+		for( auto const second : all_orientations ) {
+			passed &= check( "compose",
+			                 same_pixels( image.view( first ).then( second ),
+			                              once.view( second ) ) );
+		}
+	}
+
+	// Four quarter turns and two flips are the identity
+	passed &= check( "rotation order",
+	                 image.view( orientation::identity )
+	                     .rotated( 1 )
+	                     .rotated( 1 )
+	                     .rotated( 1 )
+	                     .rotated( 1 )
+	                     .is_identity( ) );
+	passed &= check( "flip order", image.view( orientation::identity )
+	                                 .flipped_horizontal( )
+	                                 .flipped_vertical( )
+	                                 .get_orientation( ) ==
+	                                 orientation::rotate_180 );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "oriented view tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "filterdawgs.h"
+#include "filterdawgs2.h"
+#include "filterdawgscolourize.h"
+#include "filterrotate.h"
+#include "genericimage.h"
+#include "pipeline.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+} // namespace
+
+int main( int, char ** ) {
+	auto const image = make_image( 157, 93, 7 );
+	bool passed = true;
+
+	// Small bands so that every run has several bands and chunks
+	auto const band_bytes = 157 * sizeof( rgb3 ) * 5;
+
+	{
+		Pipeline pipeline( image.view( ), band_bytes );
+		passed &= check( "dawgs", same_pixels( pipeline.dawgs( ).run( ),
+		                                       FilterDAWGS::filter( image ) ) );
+	}
+	{
+		Pipeline pipeline( image.view( ), band_bytes );
+		passed &= check( "dawgs2", same_pixels( pipeline.dawgs2( ).run( ),
+		                                        FilterDAWGS2::filter( image ) ) );
+	}
+
+	{
+		auto const rotated = FilterRotate::filter( image, 1 );
+		Pipeline pipeline( image.view( ), band_bytes );
+		pipeline.rotate( 1 ).dawgs( );
+		auto const expected = FilterDAWGS::filter_gs( rotated );
+		auto const actual = pipeline.run_gs( );
+		passed &= check( "rotate then dawgs",
+		                 std::equal( expected.cbegin( ), expected.cend( ),
+		                             actual.cbegin( ), actual.cend( ) ) );
+		passed &= check( "two passes", pipeline.pass_count( ) == 2 );
+	}
+
+	{
+		// Two barriers, each sees the output of the stages before it
+		auto const gs = FilterDAWGS::filter_gs( image );
+		auto const inverted = []( Pipeline::band const &pixels ) {
+			for( size_t n = 0; n < pixels.size( ); ++n ) {
+				auto &p = pixels.pixels[n];
+				p = rgb3( static_cast<uint8_t>( 255 - p.red ),
+				          static_cast<uint8_t>( 255 - p.green ),
+				          static_cast<uint8_t>( 255 - p.blue ) );
+			}
+		};
+		Pipeline pipeline( image.view( ), band_bytes );
+		pipeline.map( inverted )
+		  .dawgs2( )
+		  .colourize( gs, FilterDAWGSColourize::repaint_formulas::HSL );
+		passed &= check( "three passes", pipeline.pass_count( ) == 3 );
+
+		auto step = image;
+		for( auto &p : step ) {
+			p = rgb3( static_cast<uint8_t>( 255 - p.red ),
+			          static_cast<uint8_t>( 255 - p.green ),
+			          static_cast<uint8_t>( 255 - p.blue ) );
+		}
+		auto const expected = FilterDAWGSColourize::filter(
+		  FilterDAWGS2::filter( step ), gs,
+		  FilterDAWGSColourize::repaint_formulas::HSL );
+		passed &= check( "map, dawgs2, colourize",
+		                 same_pixels( pipeline.run( ), expected ) );
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "pipeline tests passed\n";
+	return EXIT_SUCCESS;
+}
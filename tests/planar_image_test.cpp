@@ -0,0 +1,124 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "filterdawgs.h"
+#include "filterdawgs2.h"
+#include "genericimage.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	bool same( rgb3 const &lhs, rgb3 const &rhs ) noexcept {
+		return lhs.red == rhs.red && lhs.green == rhs.green &&
+		       lhs.blue == rhs.blue;
+	}
+
+	bool same_levels( GenericImage<uint8_t> const &lhs,
+	                  GenericImage<uint8_t> const &rhs ) {
+		if( lhs.width( ) != rhs.width( ) || lhs.height( ) != rhs.height( ) ) {
+			return false;
+		}
+		for( size_t y = 0; y < lhs.height( ); ++y ) {
+			for( size_t x = 0; x < lhs.width( ); ++x ) {
+				if( lhs( y, x ) != rhs( y, x ) ) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool is_cache_aligned( void const *ptr ) noexcept {
+		return reinterpret_cast<uintptr_t>( ptr ) % cache_line_size == 0;
+	}
+
+	bool check_image( size_t const width, size_t const height,
+	                  row_padding const padding ) {
+		auto const name = std::to_string( width ) + "x" + std::to_string( height ) +
+		                  ( padding == row_padding::none ? "" : " padded" );
+		auto const image = make_image( width, height, 17, 0xFF, padding );
+		auto const planar = to_planar( image );
+		bool passed = true;
+
+		bool planes = planar.width( ) == width && planar.height( ) == height;
+		for( size_t y = 0; y < height && planes; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				auto const pos = y * width + x;
+				planes &= planar.red( )[pos] == image( y, x ).red &&
+				          planar.green( )[pos] == image( y, x ).green &&
+				          planar.blue( )[pos] == image( y, x ).blue &&
+				          same( planar( y, x ), image( y, x ) );
+			}
+		}
+		passed &= check( "to_planar " + name, planes );
+		passed &= check( "to_planar alignment " + name,
+		                 is_cache_aligned( planar.red( ) ) &&
+		                   is_cache_aligned( planar.green( ) ) &&
+		                   is_cache_aligned( planar.blue( ) ) );
+
+		auto const packed = to_packed( planar );
+		bool round_trip = packed.width( ) == width && packed.height( ) == height;
+		for( size_t y = 0; y < height && round_trip; ++y ) {
+			for( size_t x = 0; x < width; ++x ) {
+				round_trip &= same( packed( y, x ), image( y, x ) );
+			}
+		}
+		passed &= check( "to_packed " + name, round_trip );
+
+		passed &= check( "FilterDAWGS::filter_gs planar " + name,
+		                 same_levels( FilterDAWGS::filter_gs( image ),
+		                              FilterDAWGS::filter_gs( planar ) ) );
+		passed &= check( "FilterDAWGS2::filter_gs planar " + name,
+		                 same_levels( FilterDAWGS2::filter_gs( image ),
+		                              FilterDAWGS2::filter_gs( planar ) ) );
+		return passed;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	for( auto const padding : {row_padding::none, row_padding::cache_line} ) {
+		passed &= check_image( 1, 1, padding );
+		passed &= check_image( 67, 3, padding );
+		passed &= check_image( 301, 199, padding );
+	}
+
+	PlanarImage<uint8_t> image( 5, 4 );
+	image.set( 7, rgb3( 1, 2, 3 ) );
+	passed &= check( "PlanarImage::set",
+	                 same( image( 1, 2 ), rgb3( 1, 2, 3 ) ) &&
+	                   image.red( )[7] == 1 && image.green( )[7] == 2 &&
+	                   image.blue( )[7] == 3 );
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "planar image tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "genericrgb.h"
+#include "repaintkernels.h"
+
+namespace {
+	using namespace daw::imaging;
+
+	uint32_t distance( uint32_t const a, uint32_t const b ) noexcept {
+		return a < b ? b - a : a - b;
+	}
+
+	using scalar_t = GenericRGB<uint32_t> ( * )( rgb3, uint8_t );
+	using block_t = void ( * )( impl::repaint_block const &,
+	                            impl::repaint_result & );
+
+	// Compare the block kernel of a formula against its scalar version over a
+	// grid of colours and grayscale values
+	bool check_formula( std::string const &name, scalar_t scalar,
+	                    block_t block ) {
+		impl::repaint_block in;
+		impl::repaint_result out;
+		rgb3 pixels[impl::repaint_lanes];
+		uint8_t levels[impl::repaint_lanes];
+		size_t count = 0;
+		uint32_t worst = 0;
+
+		auto const flush = [&]( ) {
+			impl::load_repaint_block( pixels, levels, count, in );
+			block( in, out );
+			for( size_t n = 0; n < count; ++n ) {
+				auto const expected = scalar( pixels[n], levels[n] );
+				worst = std::max( {worst, distance( expected.red, out.red[n] ),
+				                   distance( expected.green, out.green[n] ),
+				                   distance( expected.blue, out.blue[n] )} );
+			}
+			count = 0;
+		};
+
+		for( uint32_t red = 0; red < 256; red += 5 ) {
+			for( uint32_t green = 0; green < 256; green += 5 ) {
+				for( uint32_t blue = 0; blue < 256; blue += 5 ) {
+					for( uint32_t gs = 0; gs < 256; gs += 3 ) {
+						pixels[count] =
+						  rgb3( static_cast<uint8_t>( red ), static_cast<uint8_t>( green ),
+						        static_cast<uint8_t>( blue ) );
+						levels[count] = static_cast<uint8_t>( gs );
+						if( ++count == impl::repaint_lanes ) {
+							flush( );
+						}
+					}
+				}
+			}
+		}
+		flush( );
+		std::cout << name << ": max difference " << worst << '\n';
+		return worst <= impl::repaint_tolerance;
+	}
+
+	bool same( GenericRGB<uint32_t> const &lhs,
+	           GenericRGB<uint32_t> const &rhs ) noexcept {
+		return lhs.red == rhs.red && lhs.green == rhs.green &&
+		       lhs.blue == rhs.blue;
+	}
+
+	// Multiply 2 scales each channel by grayscale / max( R, G, B )
+	bool check_multiply_2( ) {
+		rgb3 const pixels[] = {rgb3( 200, 100, 50 ), rgb3( 0, 0, 0 ),
+		                       rgb3( 10, 40, 20 )};
+		uint8_t const levels[] = {128, 77, 200};
+		GenericRGB<uint32_t> const expected[] = {
+		  GenericRGB<uint32_t>( 128, 64, 32 ), GenericRGB<uint32_t>( 0, 0, 0 ),
+		  GenericRGB<uint32_t>( 50, 200, 100 )};
+
+		impl::repaint_block in;
+		impl::repaint_result out;
+		impl::load_repaint_block( pixels, levels, 3, in );
+		impl::repaint_multiply_2( in, out );
+		bool passed = true;
+		for( size_t n = 0; n < 3; ++n ) {
+			passed &= same( impl::repaint_multiply_2( pixels[n], levels[n] ),
+			                expected[n] );
+			passed &= same( GenericRGB<uint32_t>( out.red[n], out.green[n],
+			                                      out.blue[n] ),
+			                expected[n] );
+		}
+		std::cout << "Multiply 2 expected values: "
+		          << ( passed ? "passed" : "failed" ) << '\n';
+		return passed;
+	}
+
+	// A repaint where every channel of every pixel is equal has no range and
+	// normalises to black
+	bool check_flat_range( ) {
+		impl::repaint_result result;
+		for( size_t n = 0; n < impl::repaint_lanes; ++n ) {
+			result.red[n] = 100;
+			result.green[n] = 100;
+			result.blue[n] = 100;
+		}
+		impl::repaint_range range{};
+		range.add( result, impl::repaint_lanes );
+		rgb3 out[impl::repaint_lanes];
+		impl::normalise_repaint( result, impl::repaint_lanes, range,
+		                         range.scale( ), out );
+		bool passed = range.scale( ) == 0.0f;
+		for( auto const &px : out ) {
+			passed &= px.red == 0 && px.green == 0 && px.blue == 0;
+		}
+		std::cout << "flat range: " << ( passed ? "passed" : "failed" ) << '\n';
+		return passed;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	using namespace daw::imaging;
+	bool result = true;
+	result &= check_formula( "Ratio", static_cast<scalar_t>( impl::repaint_ratio ),
+	                         static_cast<block_t>( impl::repaint_ratio ) );
+	result &= check_formula( "YUV", static_cast<scalar_t>( impl::repaint_yuv ),
+	                         static_cast<block_t>( impl::repaint_yuv ) );
+	result &= check_formula( "Multiply 1",
+	                         static_cast<scalar_t>( impl::repaint_multiply_1 ),
+	                         static_cast<block_t>( impl::repaint_multiply_1 ) );
+	result &= check_formula( "Addition",
+	                         static_cast<scalar_t>( impl::repaint_addition ),
+	                         static_cast<block_t>( impl::repaint_addition ) );
+	result &= check_formula( "Multiply 2",
+	                         static_cast<scalar_t>( impl::repaint_multiply_2 ),
+	                         static_cast<block_t>( impl::repaint_multiply_2 ) );
+	result &= check_formula( "HSL", static_cast<scalar_t>( impl::repaint_hsl ),
+	                         static_cast<block_t>( impl::repaint_hsl ) );
+	result &= check_multiply_2( );
+	result &= check_flat_range( );
+
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
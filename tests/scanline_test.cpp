@@ -0,0 +1,112 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "genericrgb.h"
+#include "scanline.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	bool same( rgb3 const &lhs, rgb3 const &rhs ) noexcept {
+		return lhs.red == rhs.red && lhs.green == rhs.green &&
+		       lhs.blue == rhs.blue;
+	}
+
+	rgb3 pixel( size_t const n ) noexcept {
+		return rgb3( static_cast<uint8_t>( 3 * n + 1 ),
+		             static_cast<uint8_t>( 5 * n + 2 ),
+		             static_cast<uint8_t>( 7 * n + 3 ) );
+	}
+
+	// A FreeImage scanline of width pixels, bytes_per_pixel apart, with the
+	// channels at the FI_RGBA offsets
+	std::vector<uint8_t> make_scanline( size_t const width,
+	                                    size_t const bytes_per_pixel ) {
+		std::vector<uint8_t> result( width * bytes_per_pixel, 0xEE );
+		for( size_t n = 0; n < width; ++n ) {
+			auto *const px = result.data( ) + n * bytes_per_pixel;
+			px[FI_RGBA_RED] = pixel( n ).red;
+			px[FI_RGBA_GREEN] = pixel( n ).green;
+			px[FI_RGBA_BLUE] = pixel( n ).blue;
+		}
+		return result;
+	}
+
+	// The converted pixels match and nothing past width is written
+	bool check_decoded( std::string const &name, std::vector<rgb3> const &dst,
+	                    size_t const width ) {
+		bool passed = true;
+		for( size_t n = 0; n < width; ++n ) {
+			passed &= same( dst[n], pixel( n ) );
+		}
+		for( size_t n = width; n < dst.size( ); ++n ) {
+			passed &= same( dst[n], rgb3( 0xAB, 0xAB, 0xAB ) );
+		}
+		return check( name, passed );
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+	size_t const guard = 8;
+	// Widths around the 4 pixel SSSE3 steps and their scalar tails
+	for( size_t width = 0; width <= 37; ++width ) {
+		auto const suffix = " width " + std::to_string( width );
+		{
+			auto const src = make_scanline( width, 3 );
+			std::vector<rgb3> dst( width + guard, rgb3( 0xAB, 0xAB, 0xAB ) );
+			impl::scanline24_to_rgb3( src.data( ), dst.data( ), width );
+			passed &= check_decoded( "scanline24_to_rgb3" + suffix, dst, width );
+
+			// And back again, byte for byte
+			std::vector<uint8_t> encoded( 3 * ( width + guard ), 0xCD );
+			impl::rgb3_to_scanline24( dst.data( ), encoded.data( ), width );
+			bool round_trip =
+			  std::equal( src.begin( ), src.end( ), encoded.begin( ) );
+			for( size_t n = src.size( ); n < encoded.size( ); ++n ) {
+				round_trip &= encoded[n] == 0xCD;
+			}
+			passed &= check( "rgb3_to_scanline24" + suffix, round_trip );
+		}
+		{
+			auto const src = make_scanline( width, 4 );
+			std::vector<rgb3> dst( width + guard, rgb3( 0xAB, 0xAB, 0xAB ) );
+			impl::scanline32_to_rgb3( src.data( ), dst.data( ), width );
+			passed &= check_decoded( "scanline32_to_rgb3" + suffix, dst, width );
+		}
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "scanline tests passed\n";
+	return EXIT_SUCCESS;
+}
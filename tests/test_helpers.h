@@ -0,0 +1,91 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "genericimage.h"
+
+// Fixtures shared by the tests
+namespace daw {
+	namespace imaging {
+		namespace testing {
+			// Reports a failed check on std::cerr and returns passed
+			inline bool check( std::string const &name, bool const passed ) {
+				if( !passed ) {
+					std::cerr << name << " failed\n";
+				}
+				return passed;
+			}
+
+			// Pseudo random pixels, the same for the same seed.  Each channel is
+			// limited to channel_mask, which controls how many distinct colours,
+			// and so DAWGS keys, the image has
+			inline GenericImage<rgb3>
+			make_image( size_t const width, size_t const height,
+			            uint32_t const seed, uint8_t const channel_mask = 0xFF,
+			            row_padding const padding = row_padding::none ) {
+				GenericImage<rgb3> result( width, height, padding );
+				auto state = seed;
+				for( size_t y = 0; y < height; ++y ) {
+					for( size_t x = 0; x < width; ++x ) {
+						state = state * 1103515245U + 12345U;
+						result( y, x ) =
+						  rgb3( static_cast<uint8_t>( ( state >> 24U ) & channel_mask ),
+						        static_cast<uint8_t>( ( state >> 16U ) & channel_mask ),
+						        static_cast<uint8_t>( ( state >> 8U ) & channel_mask ) );
+					}
+				}
+				return result;
+			}
+
+			inline bool same_pixel( rgb3 const &lhs, rgb3 const &rhs ) noexcept {
+				return lhs.red == rhs.red && lhs.green == rhs.green &&
+				       lhs.blue == rhs.blue;
+			}
+
+			inline bool same_pixel( uint8_t const lhs, uint8_t const rhs ) noexcept {
+				return lhs == rhs;
+			}
+
+			// Same size and pixels.  Works for images, views and oriented views
+			template<typename Lhs, typename Rhs>
+			bool same_pixels( Lhs const &lhs, Rhs const &rhs ) {
+				if( lhs.width( ) != rhs.width( ) || lhs.height( ) != rhs.height( ) ) {
+					return false;
+				}
+				for( size_t y = 0; y < lhs.height( ); ++y ) {
+					for( size_t x = 0; x < lhs.width( ); ++x ) {
+						if( !same_pixel( lhs( y, x ), rhs( y, x ) ) ) {
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		} // namespace testing
+	}   // namespace imaging
+} // namespace daw
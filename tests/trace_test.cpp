@@ -0,0 +1,106 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "trace.h"
+#include "test_helpers.h"
+
+namespace {
+	using namespace daw::imaging;
+	using namespace daw::imaging::testing;
+
+	void traced_work( ) {
+		DAW_TRACE_SPAN( "outer" );
+		{
+			DAW_TRACE_SPAN( "inner" );
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+	}
+
+	size_t count_of( std::string const &str, std::string const &what ) {
+		size_t count = 0;
+		for( auto pos = str.find( what ); pos != std::string::npos;
+		     pos = str.find( what, pos + 1 ) ) {
+			++count;
+		}
+		return count;
+	}
+} // namespace
+
+int main( int, char ** ) {
+	bool passed = true;
+
+	traced_work( );
+	std::thread worker( &traced_work );
+	worker.join( );
+
+	auto const events = trace::events( );
+	std::ostringstream chrome{};
+	trace::write_chrome_trace( chrome );
+	auto const json = chrome.str( );
+	passed &= check( "chrome header",
+	                 json.find( "{\"traceEvents\":[" ) == 0 &&
+	                   json.find( "\"displayTimeUnit\":\"ms\"}" ) !=
+	                     std::string::npos );
+
+	if( trace::is_enabled( ) ) {
+		passed &= check( "event count", events.size( ) == 4 );
+		auto const by_start = []( auto const &lhs, auto const &rhs ) {
+			return lhs.start_ns < rhs.start_ns;
+		};
+		passed &= check( "sorted",
+		                 std::is_sorted( events.begin( ), events.end( ), by_start ) );
+		if( events.size( ) == 4 ) {
+			auto const &outer = events[0];
+			auto const &inner = events[1];
+			passed &= check( "names", std::string( outer.name ) == "outer" &&
+			                            std::string( inner.name ) == "inner" );
+			passed &= check( "nesting",
+			                 inner.start_ns >= outer.start_ns &&
+			                   inner.start_ns + inner.duration_ns <=
+			                     outer.start_ns + outer.duration_ns &&
+			                   inner.duration_ns >= 1000000 );
+			passed &= check( "threads",
+			                 events[0].thread_id == events[1].thread_id &&
+			                   events[2].thread_id != events[0].thread_id );
+		}
+		passed &= check( "chrome events", count_of( json, "\"ph\":\"X\"" ) == 4 );
+		trace::clear( );
+		passed &= check( "clear", trace::events( ).empty( ) );
+	} else {
+		passed &= check( "disabled", events.empty( ) &&
+		                               count_of( json, "\"ph\"" ) == 0 );
+	}
+
+	if( !passed ) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "trace tests passed\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,356 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2016-2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and / or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <daw/daw_benchmark.h>
+
+#include "executor.h"
+#include "genericimage.h"
+#include "imagepool.h"
+#include "orientedview.h"
+#include "pipeline.h"
+#include "trace.h"
+
+// Filters a batch of image files.  Decode, filter and encode run as separate
+// stages connected by bounded queues, so while one image is encoded the next
+// ones are already being filtered and decoded
+namespace {
+	using namespace daw::imaging;
+	namespace fs = boost::filesystem;
+
+	struct filter_stage {
+		std::string name;
+		bool reorients;
+		bool gray_output;
+		void ( *apply )( Pipeline & );
+	};
+
+	template<orientation O>
+	void apply_orientation( Pipeline &pipeline ) {
+		pipeline.orient( O );
+	}
+
+	std::vector<filter_stage> const &known_stages( ) {
+		static std::vector<filter_stage> const stages = {
+		  {"rotate90", true, false, &apply_orientation<orientation::rotate_90>},
+		  {"rotate180", true, false, &apply_orientation<orientation::rotate_180>},
+		  {"rotate270", true, false, &apply_orientation<orientation::rotate_270>},
+		  {"flip_horizontal", true, false,
+		   &apply_orientation<orientation::flip_horizontal>},
+		  {"flip_vertical", true, false,
+		   &apply_orientation<orientation::flip_vertical>},
+		  {"transpose", true, false, &apply_orientation<orientation::transpose>},
+		  {"transverse", true, false,
+		   &apply_orientation<orientation::transverse>},
+		  {"dawgs", false, true, []( Pipeline &pipeline ) { pipeline.dawgs( ); }},
+		  {"dawgs2", false, true,
+		   []( Pipeline &pipeline ) { pipeline.dawgs2( ); }}};
+		return stages;
+	}
+
+	std::vector<filter_stage> parse_chain( std::string const &chain ) {
+		std::vector<std::string> names{};
+		boost::split( names, chain, boost::is_any_of( "," ) );
+		std::vector<filter_stage> result{};
+		for( auto const &name : names ) {
+			auto const &stages = known_stages( );
+			auto const pos = std::find_if(
+			  stages.begin( ), stages.end( ),
+			  [&name]( filter_stage const &s ) { return s.name == name; } );
+			if( pos == stages.end( ) ) {
+				throw std::runtime_error( "Unknown filter '" + name + "'" );
+			}
+			// Orientations are fused into how the source is read
+			if( pos->reorients && !result.empty( ) && !result.back( ).reorients ) {
+				throw std::runtime_error( "Filter '" + name +
+				                          "' must come before other filters" );
+			}
+			result.push_back( *pos );
+		}
+		return result;
+	}
+
+	// Outputs are named after their input file, so two inputs with the same
+	// file name, e.g. from different directories, would overwrite each other
+	void check_output_names( std::vector<fs::path> const &files ) {
+		std::vector<std::pair<fs::path, fs::path>> names{};
+		names.reserve( files.size( ) );
+		for( auto const &file : files ) {
+			names.emplace_back( file.filename( ), file );
+		}
+		std::sort( names.begin( ), names.end( ) );
+		auto const pos = std::adjacent_find(
+		  names.begin( ), names.end( ), []( auto const &lhs, auto const &rhs ) {
+			  return lhs.first == rhs.first;
+		  } );
+		if( pos != names.end( ) ) {
+			throw std::runtime_error( "Inputs '" + pos->second.string( ) + "' and '" +
+			                          std::next( pos )->second.string( ) +
+			                          "' would both be written to '" +
+			                          pos->first.string( ) + "'" );
+		}
+	}
+
+	// Regular files given directly, or every regular file of a directory in
+	// name order.  Fails if two of them have the same file name
+	std::vector<fs::path> list_inputs( std::vector<std::string> const &inputs ) {
+		std::vector<fs::path> result{};
+		for( auto const &input : inputs ) {
+			fs::path const path( input );
+			if( fs::is_directory( path ) ) {
+				std::vector<fs::path> files{};
+				for( auto const &entry : fs::directory_iterator( path ) ) {
+					if( fs::is_regular_file( entry.path( ) ) ) {
+						files.push_back( entry.path( ) );
+					}
+				}
+				std::sort( files.begin( ), files.end( ) );
+				result.insert( result.end( ), files.begin( ), files.end( ) );
+			} else {
+				result.push_back( path );
+			}
+		}
+		check_output_names( result );
+		return result;
+	}
+
+	// Runs func when a stage exits, normally or by any exception, so the
+	// queues around it are closed and no other stage waits on it forever
+	template<typename Func>
+	class stage_exit {
+		Func m_func;
+
+	public:
+		explicit stage_exit( Func func )
+		  : m_func( std::move( func ) ) {}
+
+		stage_exit( stage_exit const & ) = delete;
+		stage_exit &operator=( stage_exit const & ) = delete;
+
+		~stage_exit( ) {
+			m_func( );
+		}
+	};
+
+	struct decoded_item {
+		fs::path path;
+		GenericImage<rgb3> image;
+	};
+
+	struct filtered_item {
+		fs::path path;
+		std::variant<GenericImage<rgb3>, GenericImage<uint8_t>> image;
+	};
+
+	struct batch_counts {
+		std::atomic<size_t> done{0};
+		std::atomic<size_t> failed{0};
+	};
+
+	void report_failure( batch_counts &counts, fs::path const &path,
+	                     char const *stage, std::exception const &ex ) {
+		++counts.failed;
+		std::cerr << path.string( ) << ": " << stage << " failed: " << ex.what( )
+		          << '\n';
+	}
+} // namespace
+
+int main( int argc, char **argv ) {
+	namespace po = boost::program_options;
+
+	std::vector<std::string> inputs{};
+	std::string output_dir{};
+	std::string chain{};
+	std::string trace_file{};
+	size_t queue_depth = 4;
+	size_t decoders = 2;
+	size_t encoders = 2;
+
+	po::options_description desc( "Options" );
+	desc.add_options( )( "help", "print option descriptions" )(
+	  "output,o", po::value<std::string>( &output_dir )->required( ),
+	  "output directory" )(
+	  "filters,f", po::value<std::string>( &chain )->default_value( "dawgs" ),
+	  "comma separated filter chain.  Orientations (rotate90, rotate180, "
+	  "rotate270, flip_horizontal, flip_vertical, transpose, transverse) come "
+	  "first, then dawgs or dawgs2" )(
+	  "queue-depth", po::value<size_t>( &queue_depth )->default_value( 4 ),
+	  "images held between two stages" )(
+	  "decoders", po::value<size_t>( &decoders )->default_value( 2 ),
+	  "decode threads" )( "encoders",
+	                      po::value<size_t>( &encoders )->default_value( 2 ),
+	                      "encode threads" )(
+	  "trace", po::value<std::string>( &trace_file ),
+	  "write a Chrome trace of the filter stages to this file.  Needs a build "
+	  "with DAWFILTER_TRACING" )(
+	  "input", po::value<std::vector<std::string>>( &inputs )->required( ),
+	  "image files or directories" );
+
+	po::positional_options_description positional{};
+	positional.add( "input", -1 );
+
+	try {
+		po::variables_map vm{};
+		po::store( po::command_line_parser( argc, argv )
+		             .options( desc )
+		             .positional( positional )
+		             .run( ),
+		           vm );
+		if( vm.count( "help" ) != 0 ) {
+			std::cout << "Usage: " << argv[0]
+			          << " [options] -o output_dir input...\n"
+			          << desc << '\n';
+			return EXIT_SUCCESS;
+		}
+		po::notify( vm );
+	} catch( std::exception const &ex ) {
+		std::cerr << ex.what( ) << "\n" << desc << '\n';
+		return EXIT_FAILURE;
+	}
+
+	try {
+		auto const stages = parse_chain( chain );
+		auto const gray_output = !stages.empty( ) && stages.back( ).gray_output;
+		auto const files = list_inputs( inputs );
+		fs::create_directories( output_dir );
+
+		BoundedQueue<decoded_item> decoded( queue_depth );
+		BoundedQueue<filtered_item> filtered( queue_depth );
+		batch_counts counts{};
+		auto const decode_threads = std::max( decoders, size_t{1} );
+		auto const encode_threads = std::max( encoders, size_t{1} );
+		std::atomic<size_t> next_file{0};
+		std::atomic<size_t> decoders_running{decode_threads};
+		std::atomic<size_t> encoders_running{encode_threads};
+
+		// Batches are often of same sized images, so reuse their buffers
+		set_image_memory_resource( &default_image_pool( ) );
+
+		auto const start = std::chrono::steady_clock::now( );
+		Executor executor{};
+		for( size_t n = 0; n < decode_threads; ++n ) {
+			executor.spawn( [&]( ) {
+				stage_exit const close_decoded( [&]( ) {
+					if( --decoders_running == 0 ) {
+						decoded.close( );
+					}
+				} );
+				for( auto pos = next_file++; pos < files.size( ); pos = next_file++ ) {
+					try {
+						decoded_item item{files[pos], from_file( files[pos].string( ) )};
+						// Closed when the filter stage has stopped
+						if( !decoded.push( std::move( item ) ) ) {
+							return;
+						}
+					} catch( std::exception const &ex ) {
+						report_failure( counts, files[pos], "decode", ex );
+					}
+				}
+			} );
+		}
+
+		// One filter stage, the filters are parallel internally
+		executor.spawn( [&]( ) {
+			// Closing decoded too stops the decoders if this stage fails
+			stage_exit const close_queues( [&]( ) {
+				filtered.close( );
+				decoded.close( );
+			} );
+			while( auto item = decoded.pop( ) ) {
+				try {
+					Pipeline pipeline( item->image.view( ) );
+					for( auto const &stage : stages ) {
+						stage.apply( pipeline );
+					}
+					auto result =
+					  gray_output ? filtered_item{item->path, pipeline.run_gs( )}
+					              : filtered_item{item->path, pipeline.run( )};
+					// Closed when every encoder has stopped
+					if( !filtered.push( std::move( result ) ) ) {
+						return;
+					}
+				} catch( std::exception const &ex ) {
+					report_failure( counts, item->path, "filter", ex );
+				}
+			}
+		} );
+
+		for( size_t n = 0; n < encode_threads; ++n ) {
+			executor.spawn( [&]( ) {
+				// The filter stage would block on a full queue once every encoder
+				// has stopped
+				stage_exit const close_filtered( [&]( ) {
+					if( --encoders_running == 0 ) {
+						filtered.close( );
+					}
+				} );
+				while( auto item = filtered.pop( ) ) {
+					auto const out_path =
+					  ( fs::path( output_dir ) / item->path.filename( ) ).string( );
+					try {
+						std::visit(
+						  [&out_path]( auto const &image ) { image.to_file( out_path ); },
+						  item->image );
+						++counts.done;
+					} catch( std::exception const &ex ) {
+						report_failure( counts, item->path, "encode", ex );
+					}
+				}
+			} );
+		}
+		executor.wait( );
+
+		auto const elapsed = std::chrono::duration<double>(
+		                       std::chrono::steady_clock::now( ) - start )
+		                       .count( );
+		std::cout << counts.done << " images in "
+		          << daw::utility::format_seconds( elapsed, 2 ) << ", "
+		          << ( elapsed > 0.0 ? static_cast<double>( counts.done ) / elapsed
+		                             : 0.0 )
+		          << " images/s";
+		if( counts.failed > 0 ) {
+			std::cout << ", " << counts.failed << " failed";
+		}
+		std::cout << '\n';
+		if( !trace_file.empty( ) ) {
+			trace::write_chrome_trace( trace_file );
+		}
+		return counts.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	} catch( std::exception const &ex ) {
+		std::cerr << ex.what( ) << '\n';
+		return EXIT_FAILURE;
+	}
+}